@@ -1,64 +1,759 @@
-/********************************************************************************
-* adc.c: Innehller funktionsdefinitioner fr implementering av AD-omvandling
-*        fr analoga signaler via strukten adc.
-********************************************************************************/
-#include "adc.h"
-
-/********************************************************************************
-* adc_init: Initierar analog pin fr avlsning och AD-omvandling av insignaler,
-*           som antingen kan anges som ett tal mellan 0 - 5 eller via konstanter
-*           A0 - A5 (som motsvarar heltal 14 - 19).
-*
-*           - self: Pekare till analog pin som ska anvndas fr AD-omvandling.
-*           - pin : Analog pin som ska lsas fr AD-omvandling.
-********************************************************************************/
-void adc_init(struct adc* self,
-              const uint8_t pin)
-{
-   if (pin >= 0 && pin <= 5)
-   {
-      self->pin = pin;
-   }
-   else if (pin >= 14 && pin <= 19)
-   {
-      self->pin = pin - 14;
-   }
-
-   self->pwm_on_us = 0;
-   self->pwm_off_us = 0;
-
-   (void)adc_read(self);
-   return;
-}
-
-/********************************************************************************
-* adc_read: Lser av en analog insignal och returnerar motsvarande digitala
-*           motsvarighet mellan 0 - 1023.
-*
-*           - self: Pekare till analog pin som ska lsas av.
-********************************************************************************/
-uint16_t adc_read(const struct adc* self)
-{
-   ADMUX = (1 << REFS0) | self->pin;
-   ADCSRA = (1 << ADEN) | (1 << ADSC) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
-   while ((ADCSRA & (1 << ADIF)) == 0);
-   ADCSRA = (1 << ADIF);
-   return ADC;
-}
-
-/********************************************************************************
-* adc_get_pwm_values: Lser av en analog insignal och berknar on- och off-tid
-*                     fr PWM-generering, avrundat till nrmaste heltal.
-*
-*                     - self         : Pekare till analog pin som ska lsas av.
-*                     - pwm_period_us: PWM-perioden (on-tid + off-tid) mtt i
-*                                      mikrosekunder (default = 10 000 us).
-********************************************************************************/
-void adc_get_pwm_values(struct adc* self,
-                        uint16_t pwm_period_us)
-{
-   if (!pwm_period_us) pwm_period_us = 10000;
-   self->pwm_on_us = (uint16_t)(adc_duty_cycle(self) * pwm_period_us + 0.5);
-   self->pwm_off_us = pwm_period_us - self->pwm_on_us;
-   return;
+/********************************************************************************
+* adc.c: Innehåller funktionsdefinitioner för implementering av AD-omvandling
+*        för analoga signaler via strukten adc.
+********************************************************************************/
+#include "adc.h"
+#include "led.h"
+#include "serial.h"
+#include "sysclock.h"
+#include "isr_probe.h"
+
+/* Makrodefinitioner: */
+#define ADC_PRESCALER ADC_PRESCALER_128                              /* Prescaler vid kontinuerlig omvandling (125 kHz). */
+#define ADC_BUFFER_MASK (ADC_BUFFER_SIZE - 1)                        /* Bitmask för index i ringbuffertarna. */
+#define ADC_SLOT_KEEP 0x01                                           /* Flagga i position för resultat som ska lagras. */
+#define ADC_TRIGGER_STEP_MAX 65000                                   /* Största delsteg för OCR1B (marginal mot 16 bitar). */
+
+/* Statiska variabler: */
+static volatile uint16_t results[ADC_CHANNELS];  /* Senaste resultat per kanal. */
+static volatile uint8_t sequences[ADC_CHANNELS]; /* Sekvensnummer per kanal. */
+static volatile uint16_t samples[ADC_CHANNELS][ADC_BUFFER_SIZE]; /* Ringbuffert per kanal. */
+static volatile uint8_t heads[ADC_CHANNELS];     /* Index där nästa resultat lagras per kanal. */
+static volatile uint8_t tails[ADC_CHANNELS];     /* Index för äldsta ohämtade resultat per kanal. */
+static volatile uint16_t overruns = 0;           /* Antal resultat som har skrivits över. */
+static volatile uint8_t scan_mask = 0;           /* Kanaler som omvandlas, 0 = stoppad. */
+static volatile bool scan_discard = false;       /* Indikerar ifall första resultat efter kanalbyte slängs. */
+static volatile uint8_t current = 0;             /* Position vars resultat erhålls vid nästa avbrott. */
+static volatile uint8_t following = 0;           /* Position som är vald för omvandlingen därefter. */
+static volatile uint32_t sums[ADC_CHANNELS];     /* Ackumulerade resultat per kanal vid översampling. */
+static volatile uint8_t counts[ADC_CHANNELS];    /* Antal ackumulerade resultat per kanal. */
+static volatile uint8_t extra_bits = 0;          /* Extra bitar via översampling (0 - ADC_OVERSAMPLING_MAX). */
+static volatile uint8_t oversampling_mask = 0;   /* Antal resultat per utvärde minus ett, dvs. 4^n - 1. */
+static volatile bool dither_enabled = false;     /* Indikerar ifall dither-pinnen används. */
+static struct led dither;                        /* Utsignal för dither, se ADC_DITHER_PIN. */
+static volatile bool quiet_pending = false;      /* Indikerar att en omvandling i sleep mode pågår. */
+static volatile uint8_t trigger_steps = 0;       /* Delsteg per period vid triggning, 0 = Free Running. */
+static volatile uint8_t trigger_count = 0;       /* Antal passerade delsteg i aktuell period. */
+static volatile uint16_t trigger_step = 0;       /* Delsteg för OCR1B i räknarsteg. */
+static volatile uint16_t trigger_extra = 0;      /* Rest som läggs till sista delsteget i varje period. */
+static volatile uint16_t trigger_misses = 0;     /* Antal missade compare-tillfällen. */
+static uint32_t trigger_period_us = 0;           /* Samplingsperiod vid triggning. */
+
+/* Statiska funktioner: */
+static uint16_t adc_convert(const struct adc* self,
+                            const bool quiet);
+static inline void adc_sleep_until_converted(const uint8_t prescaler_bits);
+static bool adc_scan_prepare(const uint8_t channel_mask,
+                             const bool discard);
+static inline bool adc_trigger_advance(void);
+static inline uint8_t adc_next_slot(const uint8_t slot);
+static inline void adc_store(const uint8_t channel,
+                             const uint16_t result);
+
+/********************************************************************************
+* adc_init: Initierar analog pin för avläsning och AD-omvandling av insignaler,
+*           som antingen kan anges som ett tal mellan 0 - 5 eller via konstanter
+*           A0 - A5 (som motsvarar heltal 14 - 19).
+*
+*           - self: Pekare till analog pin som ska användas för AD-omvandling.
+*           - pin : Analog pin som ska läsas för AD-omvandling.
+********************************************************************************/
+void adc_init(struct adc* self,
+              const uint8_t pin)
+{
+   if (pin >= 0 && pin <= 5)
+   {
+      self->pin = pin;
+   }
+   else if (pin >= 14 && pin <= 19)
+   {
+      self->pin = pin - 14;
+   }
+
+   self->pwm_on_us = 0;
+   self->pwm_off_us = 0;
+   self->prescaler_bits = ADC_PRESCALER_128;
+   self->eight_bit = false;
+
+   (void)adc_read(self);
+   return;
+}
+
+/********************************************************************************
+* adc_read: Läser av en analog insignal och returnerar motsvarande digitala
+*           motsvarighet mellan 0 - 2^bits - 1. Under kontinuerlig
+*           omvandling läses resultatet med avbrott inaktiverade, eftersom
+*           det är 16 bitar. Vid 8-bitars avläsning skiftas resultatet då
+*           ned till 8 bitar.
+*
+*           - self: Pekare till analog pin som ska läsas av.
+********************************************************************************/
+uint16_t adc_read(const struct adc* self)
+{
+   if (!scan_mask) return adc_convert(self, false);
+
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint16_t result = results[self->pin];
+   SREG = sreg;
+
+   if (self->eight_bit) return result >> (adc_resolution() - 8);
+   return result;
+}
+
+/********************************************************************************
+* adc_sequence: Returnerar sekvensnumret för senaste resultat på angiven kanal.
+*
+*               - self: Pekare till analog pin vars sekvensnummer ska läsas.
+********************************************************************************/
+uint8_t adc_sequence(const struct adc* self)
+{
+   return sequences[self->pin];
+}
+
+/********************************************************************************
+* adc_scan_start: Startar kontinuerlig omvandling av angivna kanaler. Första
+*                 omvandlingen startas på kanalen med lägst nummer. I Free
+*                 Running Mode startar nästa omvandling direkt när föregående
+*                 är klar, med kanalen som var vald i ADMUX vid det tillfället.
+*                 Byte av kanal i avbrottsrutinen påverkar därmed först
+*                 omvandlingen efter nästa, se avbrottsrutinen nedan.
+*
+*                 Ringbuffertarna töms samt räknaren för överskrivna resultat
+*                 nollställs vid start.
+*
+*                 - channel_mask: Bitmask med en bit per kanal A0 - A5.
+*                 - discard     : Indikerar ifall första resultatet efter
+*                                 varje kanalbyte ska slängas.
+********************************************************************************/
+void adc_scan_start(const uint8_t channel_mask,
+                    const bool discard)
+{
+   if (!adc_scan_prepare(channel_mask, discard)) return;
+
+   ADCSRB = 0;
+   ADCSRA = (1 << ADEN) | (1 << ADSC) | (1 << ADATE) | (1 << ADIF) | (1 << ADIE) | ADC_PRESCALER;
+   return;
+}
+
+/********************************************************************************
+* adc_trigger_start: Startar omvandling av angivna kanaler med fast
+*                    samplingsperiod, där varje omvandling startas av
+*                    hårdvaran via Auto Trigger vid compare match B i
+*                    Timer 1 (ADTS = 101). Timer 1 löper fritt som
+*                    systemets tidsbas (se sysclock.h), varför OCR1B flyttas
+*                    fram en period i taget i avbrottsrutinen.
+*                    Avståndet mellan omvandlingarna blir därmed exakt,
+*                    oberoende av avbrottsfördröjning.
+*
+*                    Perioder längre än ADC_TRIGGER_STEP_MAX räknarsteg
+*                    (ca 32 ms med prescaler 8) delas upp i lika långa delsteg, där resten
+*                    läggs till sista delsteget. Omvandlingar vid övriga
+*                    delsteg slängs utan att kanal byts.
+*
+*                    - channel_mask: Bitmask med en bit per kanal A0 - A5.
+*                    - discard     : Indikerar ifall första resultatet efter
+*                                    varje kanalbyte ska slängas.
+*                    - period_us   : Tid mellan omvandlingarna i mikrosekunder.
+********************************************************************************/
+void adc_trigger_start(const uint8_t channel_mask,
+                       const bool discard,
+                       uint32_t period_us)
+{
+   if (period_us < ADC_TRIGGER_PERIOD_MIN_US) period_us = ADC_TRIGGER_PERIOD_MIN_US;
+   if (period_us > ADC_TRIGGER_PERIOD_MAX_US) period_us = ADC_TRIGGER_PERIOD_MAX_US;
+
+   const uint32_t ticks = period_us * SYSCLOCK_COUNTS_PER_US;
+   const uint8_t steps = (uint8_t)((ticks + ADC_TRIGGER_STEP_MAX - 1) / ADC_TRIGGER_STEP_MAX);
+
+   if (!adc_scan_prepare(channel_mask, discard)) return;
+
+   const uint8_t sreg = SREG;
+   asm("CLI");
+
+   trigger_period_us = period_us;
+   trigger_steps = steps;
+   trigger_count = 0;
+   trigger_step = (uint16_t)(ticks / steps);
+   trigger_extra = (uint16_t)(ticks - (uint32_t)trigger_step * steps);
+   trigger_misses = 0;
+
+   OCR1B = TCNT1 + trigger_step;
+   TIFR1 = (1 << OCF1B);
+   ADCSRB = (1 << ADTS2) | (1 << ADTS0);
+   ADCSRA = (1 << ADEN) | (1 << ADATE) | (1 << ADIF) | (1 << ADIE) | ADC_PRESCALER;
+
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* adc_trigger_misses: Returnerar antalet compare-tillfällen som har missats
+*                     sedan start, eftersom avbrottsrutinen fördröjdes så
+*                     länge att Timer 1 hann passera nästa compare-värde.
+*                     Missade tillfällen hoppas över, så att efterföljande
+*                     omvandlingar fortsätter i samma takt.
+********************************************************************************/
+uint16_t adc_trigger_misses(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint16_t misses = trigger_misses;
+   SREG = sreg;
+   return misses;
+}
+
+/********************************************************************************
+* adc_scan_stop: Stoppar kontinuerlig omvandling genom att AD-omvandlaren
+*                inaktiveras, vilket avbryter pågående omvandling. Eventuell
+*                kvarvarande avbrottsflagga nollställs, så att nästa
+*                blockerande omvandling inte returnerar direkt. Triggning
+*                via Timer 1 inaktiveras också.
+********************************************************************************/
+void adc_scan_stop(void)
+{
+   ADCSRA = (1 << ADIF);
+   ADCSRB = 0;
+   scan_mask = 0;
+   trigger_steps = 0;
+   return;
+}
+
+/********************************************************************************
+* adc_scan_running: Indikerar ifall kontinuerlig omvandling pågår.
+********************************************************************************/
+bool adc_scan_running(void)
+{
+   return scan_mask != 0;
+}
+
+/********************************************************************************
+* adc_scan_rate: Returnerar antalet lagrade resultat per sekund totalt. En
+*                omvandling i Free Running Mode tar 13 cykler av ADC-klockan,
+*                dvs. F_CPU / 128 / 13, vilket halveras ifall första
+*                resultatet efter varje kanalbyte slängs. Vid översampling
+*                delas hastigheten med antalet resultat per utvärde (4^n).
+*                Vid triggning utgörs hastigheten i stället av inversen av
+*                samplingsperioden (avrundat nedåt till heltal).
+********************************************************************************/
+uint16_t adc_scan_rate(void)
+{
+   uint16_t rate = (uint16_t)(F_CPU / 128 / 13);
+   if (!scan_mask) return 0;
+   if (trigger_steps) rate = (uint16_t)(1000000UL / trigger_period_us);
+   rate >>= 2 * extra_bits;
+   return scan_discard ? rate / 2 : rate;
+}
+
+/********************************************************************************
+* adc_set_oversampling: Sätter antalet extra bitar via översampling, där 4^n
+*                       resultat ackumuleras och decimeras (skiftas n steg åt
+*                       höger) till ett utvärde på 10 + n bitar. Pågående
+*                       ackumulering nollställs och ringbuffertarna töms med
+*                       avbrott inaktiverade, så att resultat med olika
+*                       upplösning inte blandas.
+*
+*                       - bits     : Antal extra bitar (0 - ADC_OVERSAMPLING_MAX).
+*                       - use_dither: Indikerar ifall dither-pinnen ska togglas.
+********************************************************************************/
+void adc_set_oversampling(uint8_t bits,
+                          const bool use_dither)
+{
+   if (bits > ADC_OVERSAMPLING_MAX) bits = ADC_OVERSAMPLING_MAX;
+
+   const uint8_t sreg = SREG;
+   asm("CLI");
+
+   if (use_dither && !dither_enabled)
+   {
+      led_init(&dither, ADC_DITHER_PIN);
+   }
+   else if (!use_dither && dither_enabled)
+   {
+      led_clear(&dither);
+   }
+
+   extra_bits = bits;
+   oversampling_mask = (uint8_t)((1 << (2 * bits)) - 1);
+   dither_enabled = use_dither;
+
+   for (uint8_t i = 0; i < ADC_CHANNELS; ++i)
+   {
+      sums[i] = 0;
+      counts[i] = 0;
+      heads[i] = 0;
+      tails[i] = 0;
+   }
+
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* adc_resolution: Returnerar aktuell upplösning i bitar (10 - 14).
+********************************************************************************/
+uint8_t adc_resolution(void)
+{
+   return ADC_RESOLUTION + extra_bits;
+}
+
+/********************************************************************************
+* adc_read_quiet: Läser av en analog insignal via omvandling i ADC Noise
+*                 Reduction Mode, se adc_read_quiet_batch.
+*
+*                 - self: Pekare till analog pin som ska läsas av.
+********************************************************************************/
+uint16_t adc_read_quiet(const struct adc* self)
+{
+   uint16_t result;
+   adc_read_quiet_batch(self, &result, 1);
+   return result;
+}
+
+/********************************************************************************
+* adc_read_quiet_batch: Genomför angivet antal avläsningar i följd i ADC Noise
+*                       Reduction Mode. Inför första omvandlingen töms
+*                       sändbufferten, eftersom USART stängs av under sleep.
+*                       Därefter sparas och inaktiveras avbrott från timers,
+*                       externa avbrott, PCI-avbrott samt USART, så att
+*                       processorn endast väcks av ADC_vect (samt eventuellt
+*                       Watchdog-avbrott, vars register kräver en tidsbunden
+*                       sekvens och därför lämnas orört). Sparade
+*                       avbrottsmasker, sleep mode samt avbrottsstatus
+*                       återställs efteråt. Avbrott som har flaggats under
+*                       tiden hanteras direkt efter återställningen.
+*
+*                       Under kontinuerlig omvandling är AD-omvandlaren
+*                       upptagen, varför senaste resultat från cachen
+*                       returneras i stället.
+*
+*                       - self  : Pekare till analog pin som ska läsas av.
+*                       - values: Pekare till array där resultaten lagras.
+*                       - count : Antal avläsningar som ska genomföras.
+********************************************************************************/
+void adc_read_quiet_batch(const struct adc* self,
+                          uint16_t* values,
+                          const uint8_t count)
+{
+   if (scan_mask)
+   {
+      for (uint8_t i = 0; i < count; ++i)
+      {
+         values[i] = adc_read(self);
+      }
+      return;
+   }
+
+   serial_flush();
+
+   const uint8_t sreg = SREG;
+   asm("CLI");
+
+   const uint8_t smcr = SMCR;
+   const uint8_t timsk0 = TIMSK0;
+   const uint8_t timsk1 = TIMSK1;
+   const uint8_t timsk2 = TIMSK2;
+   const uint8_t eimsk = EIMSK;
+   const uint8_t pcicr = PCICR;
+   const uint8_t ucsr0b = UCSR0B;
+
+   TIMSK0 = 0;
+   TIMSK1 = 0;
+   TIMSK2 = 0;
+   EIMSK = 0;
+   PCICR = 0;
+   UCSR0B = ucsr0b & ~((1 << RXCIE0) | (1 << TXCIE0) | (1 << UDRIE0));
+   set_sleep_mode(SLEEP_MODE_ADC);
+
+   for (uint8_t i = 0; i < count; ++i)
+   {
+      values[i] = adc_convert(self, true);
+   }
+
+   ADCSRA = (1 << ADEN) | (1 << ADIF) | ADC_PRESCALER;
+   UCSR0B = ucsr0b;
+   PCICR = pcicr;
+   EIMSK = eimsk;
+   TIMSK2 = timsk2;
+   TIMSK1 = timsk1;
+   TIMSK0 = timsk0;
+   SMCR = smcr;
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* adc_buffer_read: Hämtar äldsta ohämtade resultat ur angiven kanals
+*                  ringbuffert. Läsningen sker med avbrott inaktiverade,
+*                  eftersom avbrottsrutinen flyttar fram äldsta index då
+*                  bufferten är full.
+*
+*                  - self : Pekare till analog pin vars resultat ska hämtas.
+*                  - value: Pekare till variabel där resultatet lagras.
+********************************************************************************/
+bool adc_buffer_read(const struct adc* self,
+                     uint16_t* value)
+{
+   const uint8_t channel = self->pin;
+   const uint8_t sreg = SREG;
+   asm("CLI");
+
+   if (heads[channel] == tails[channel])
+   {
+      SREG = sreg;
+      return false;
+   }
+
+   *value = samples[channel][tails[channel]];
+   tails[channel] = (tails[channel] + 1) & ADC_BUFFER_MASK;
+   SREG = sreg;
+   return true;
+}
+
+/********************************************************************************
+* adc_buffer_count: Returnerar antalet ohämtade resultat i angiven kanals
+*                   ringbuffert.
+*
+*                   - self: Pekare till analog pin vars ringbuffert ska läsas.
+********************************************************************************/
+uint8_t adc_buffer_count(const struct adc* self)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint8_t count = (heads[self->pin] - tails[self->pin]) & ADC_BUFFER_MASK;
+   SREG = sreg;
+   return count;
+}
+
+/********************************************************************************
+* adc_buffer_overruns: Returnerar antalet resultat som har skrivits över
+*                      innan de hämtades, summerat över samtliga kanaler.
+********************************************************************************/
+uint16_t adc_buffer_overruns(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint16_t count = overruns;
+   SREG = sreg;
+   return count;
+}
+
+/********************************************************************************
+* adc_get_pwm_values: Läser av en analog insignal och beräknar on- och off-tid
+*                     för PWM-generering, avrundat till närmaste heltal. On-tiden
+*                     beräknas som duty cycle i Q0.16-format gånger perioden,
+*                     skiftat 16 steg åt höger, utan flyttal.
+*
+*                     - self         : Pekare till analog pin som ska läsas av.
+*                     - pwm_period_us: PWM-perioden (on-tid + off-tid) mätt i
+*                                      mikrosekunder (default = 10 000 us).
+********************************************************************************/
+void adc_get_pwm_values(struct adc* self,
+                        uint16_t pwm_period_us)
+{
+   if (!pwm_period_us) pwm_period_us = 10000;
+   self->pwm_on_us = (uint16_t)(((uint32_t)adc_duty_cycle_q16(self) * pwm_period_us + 0x8000) >> 16);
+   self->pwm_off_us = pwm_period_us - self->pwm_on_us;
+   return;
+}
+
+/********************************************************************************
+* ISR (ADC_vect): Avbrottsrutin som äger rum när en omvandling är klar under
+*                 kontinuerlig omvandling. Varje position i omvandlingsordningen
+*                 utgörs av kanalen (bit 1 - 3) samt flaggan ADC_SLOT_KEEP, som
+*                 anger ifall resultatet ska behållas. Behållna resultat
+*                 ackumuleras per kanal, där var 4^n:e resultat medför att
+*                 summan decimeras och lagras. Nästa omvandling har redan
+*                 startats automatiskt med positionen i following, varför
+*                 ADMUX sätts till kanalen därefter.
+*
+*                 Vid dither togglas dither-pinnen en gång per varv, dvs. när
+*                 omvandlingsordningen börjar om från första kanalen. Varje
+*                 kanal omvandlas därmed växelvis med hög och låg dither-nivå,
+*                 oavsett antalet kanaler, och eftersom 4^n är jämnt tar
+*                 nivåerna ut varandra i genomsnitt. Pinnen togglas efter att
+*                 nästa omvandling har startats, varför det inte är garanterat
+*                 vilken omvandling som först ser den nya nivån, se adc.h.
+*
+*                 Utan kontinuerlig omvandling har avbrottet endast väckt
+*                 processorn efter en omvandling i ADC Noise Reduction Mode,
+*                 varvid resultatet lämnas i ADC-registret.
+*
+*                 Vid triggning via Timer 1 flyttas OCR1B fram först, se
+*                 adc_trigger_advance. Eftersom nästa omvandling inte startas
+*                 förrän vid nästa compare match gäller ny kanal i ADMUX
+*                 redan nästa omvandling, varför endast en position behöver
+*                 hållas reda på.
+********************************************************************************/
+ISR (ADC_vect)
+{
+   ISR_PROBE_ENTER(ISR_PROBE_NO_LATENCY);
+   uint8_t previous, selected;
+
+   if (!scan_mask)
+   {
+      quiet_pending = false;
+      ISR_PROBE_EXIT(ISR_PROBE_ADC);
+      return;
+   }
+
+   if (trigger_steps && !adc_trigger_advance())
+   {
+      ISR_PROBE_EXIT(ISR_PROBE_ADC);
+      return;
+   }
+
+   const uint16_t result = ADC;
+   const uint8_t channel = current >> 1;
+
+   if (current & ADC_SLOT_KEEP)
+   {
+      const uint8_t count = (counts[channel] + 1) & oversampling_mask;
+      const uint32_t sum = sums[channel] + result;
+      counts[channel] = count;
+
+      if (count)
+      {
+         sums[channel] = sum;
+      }
+      else
+      {
+         sums[channel] = 0;
+         adc_store(channel, (uint16_t)(sum >> extra_bits));
+      }
+   }
+
+   if (trigger_steps)
+   {
+      previous = current;
+      current = adc_next_slot(current);
+      selected = current;
+   }
+   else
+   {
+      previous = following;
+      current = following;
+      following = adc_next_slot(following);
+      selected = following;
+   }
+
+   ADMUX = (1 << REFS0) | (selected >> 1);
+
+   if (dither_enabled && (selected >> 1) <= (previous >> 1) &&
+       (!scan_discard || !(selected & ADC_SLOT_KEEP)))
+   {
+      led_toggle(&dither);
+   }
+   ISR_PROBE_EXIT(ISR_PROBE_ADC);
+   return;
+}
+
+/********************************************************************************
+* adc_scan_prepare: Stoppar eventuell pågående omvandling och förbereder
+*                   omvandling av angivna kanaler, där ringbuffertarna töms
+*                   och första kanalen väljs i ADMUX. Returnerar false ifall
+*                   inga giltiga kanaler har angetts.
+*
+*                   - channel_mask: Bitmask med en bit per kanal A0 - A5.
+*                   - discard     : Indikerar ifall första resultatet efter
+*                                   varje kanalbyte ska slängas.
+********************************************************************************/
+static bool adc_scan_prepare(const uint8_t channel_mask,
+                             const bool discard)
+{
+   const uint8_t mask = channel_mask & ((1 << ADC_CHANNELS) - 1);
+   uint8_t first = 0;
+
+   adc_scan_stop();
+   if (!mask) return false;
+
+   while (!(mask & (1 << first)))
+   {
+      first++;
+   }
+
+   for (uint8_t i = 0; i < ADC_CHANNELS; ++i)
+   {
+      sums[i] = 0;
+      counts[i] = 0;
+      heads[i] = 0;
+      tails[i] = 0;
+   }
+
+   overruns = 0;
+   scan_mask = mask;
+   scan_discard = discard;
+   current = (first << 1) | (discard ? 0 : ADC_SLOT_KEEP);
+   following = current;
+   ADMUX = (1 << REFS0) | first;
+   return true;
+}
+
+/********************************************************************************
+* adc_trigger_advance: Flyttar fram OCR1B till nästa delsteg och nollställer
+*                      OCF1B, eftersom Auto Trigger startar en omvandling
+*                      först när flaggan går från noll till ett. Returnerar
+*                      true ifall omvandlingen avslutar en hel period och
+*                      därmed ska behållas. Ifall Timer 1 redan har passerat
+*                      nytt compare-värde (avbrottet fördröjdes mer än ett
+*                      delsteg) flyttas värdet fram ytterligare delsteg, så
+*                      att efterföljande omvandlingar följer samma raster.
+*                      Anropas från avbrottsrutinen.
+********************************************************************************/
+static inline bool adc_trigger_advance(void)
+{
+   const bool period_done = ++trigger_count >= trigger_steps;
+   uint16_t compare = OCR1B + trigger_step;
+
+   if (period_done)
+   {
+      trigger_count = 0;
+      compare += trigger_extra;
+   }
+
+   while ((uint16_t)(compare - TCNT1) > trigger_step + trigger_extra)
+   {
+      compare += trigger_step;
+      trigger_misses++;
+   }
+
+   OCR1B = compare;
+   TIFR1 = (1 << OCF1B);
+   return period_done;
+}
+
+/********************************************************************************
+* adc_convert: Genomför blockerande omvandlingar på angiven kanal med
+*              prescaler 128 och returnerar resultatet, som även lagras som
+*              kanalens senaste resultat. Vid översampling genomförs 4^n
+*              omvandlingar i följd (upp till 256 omvandlingar, ca 27 ms),
+*              där dither-pinnen togglas efter varje omvandling.
+*
+*              Vid 8-bitars avläsning vänsterjusteras resultatet (ADLAR) och
+*              endast ADCH läses, utan översampling och utan att cachen
+*              uppdateras, eftersom cachen lagrar full upplösning.
+*
+*              - self   : Pekare till analog pin som ska omvandlas, vars
+*                         prescaler samt upplösning används.
+*              - quiet  : Indikerar ifall processorn ska sova i ADC Noise
+*                         Reduction Mode under omvandlingarna, i stället för
+*                         att vänta via pollning. Anroparen ansvarar för att
+*                         sleep mode är valt och att övriga avbrott är maskade.
+********************************************************************************/
+static uint16_t adc_convert(const struct adc* self,
+                            const bool quiet)
+{
+   const uint8_t channel = self->pin;
+   const uint8_t last = self->eight_bit ? 0 : oversampling_mask;
+   uint32_t sum = 0;
+   uint16_t i = 0;
+
+   ADMUX = (1 << REFS0) | (self->eight_bit ? (1 << ADLAR) : 0) | channel;
+
+   do
+   {
+      if (quiet)
+      {
+         adc_sleep_until_converted(self->prescaler_bits);
+      }
+      else
+      {
+         ADCSRA = (1 << ADEN) | (1 << ADSC) | self->prescaler_bits;
+         while ((ADCSRA & (1 << ADIF)) == 0);
+         ADCSRA = (1 << ADIF) | (1 << ADEN) | self->prescaler_bits;
+      }
+
+      if (self->eight_bit)
+      {
+         return ADCH;
+      }
+
+      sum += ADC;
+      if (dither_enabled) led_toggle(&dither);
+   } while (i++ < last);
+
+   results[channel] = (uint16_t)(sum >> extra_bits);
+   return results[channel];
+}
+
+/********************************************************************************
+* adc_sleep_until_converted: Genomför en omvandling i ADC Noise Reduction Mode.
+*                            AD-omvandlaren aktiveras med avbrott men utan
+*                            ADSC, eftersom omvandlingen startar automatiskt
+*                            när processorn går in i sleep mode. Avbrott
+*                            aktiveras i instruktionen före SLEEP, så att
+*                            avbrottet inte kan hinna äga rum innan processorn
+*                            sover. Ifall processorn väcks av något annat
+*                            avbrott (exempelvis Watchdog-timern) försätts den
+*                            i sleep mode igen tills omvandlingen är klar.
+*                            Avbrott är inaktiverade vid retur.
+*
+*                            - prescaler_bits: Bitar ADPS2 - ADPS0 för
+*                                              ADC-klockan.
+********************************************************************************/
+static inline void adc_sleep_until_converted(const uint8_t prescaler_bits)
+{
+   asm("CLI");
+   quiet_pending = true;
+   ADCSRA = (1 << ADEN) | (1 << ADIF) | (1 << ADIE) | prescaler_bits;
+   sleep_enable();
+
+   while (quiet_pending)
+   {
+      asm("SEI");
+      sleep_cpu();
+      asm("CLI");
+   }
+
+   sleep_disable();
+   return;
+}
+
+/********************************************************************************
+* adc_store: Lagrar ett utvärde i angiven kanals cache samt ringbuffert, där
+*            äldsta resultat skrivs över ifall bufferten är full. Anropas
+*            från avbrottsrutinen.
+*
+*            - channel: Kanalen vars utvärde ska lagras.
+*            - result : Utvärdet som ska lagras.
+********************************************************************************/
+static inline void adc_store(const uint8_t channel,
+                             const uint16_t result)
+{
+   const uint8_t head = heads[channel];
+   results[channel] = result;
+   sequences[channel]++;
+   samples[channel][head] = result;
+   heads[channel] = (head + 1) & ADC_BUFFER_MASK;
+
+   if (heads[channel] == tails[channel])
+   {
+      tails[channel] = (tails[channel] + 1) & ADC_BUFFER_MASK;
+      overruns++;
+   }
+   return;
+}
+
+/********************************************************************************
+* adc_next_slot: Returnerar nästa position i omvandlingsordningen, där
+*                kanalerna omvandlas i stigande ordning. Ifall första
+*                resultatet efter kanalbyte ska slängas omvandlas varje kanal
+*                två gånger i följd, där endast andra resultatet lagras.
+*
+*                - slot: Aktuell position (kanal samt ADC_SLOT_KEEP).
+********************************************************************************/
+static inline uint8_t adc_next_slot(const uint8_t slot)
+{
+   uint8_t channel = slot >> 1;
+
+   if (scan_discard && !(slot & ADC_SLOT_KEEP))
+   {
+      return slot | ADC_SLOT_KEEP;
+   }
+
+   do
+   {
+      channel = channel + 1 < ADC_CHANNELS ? channel + 1 : 0;
+   } while (!(scan_mask & (1 << channel)));
+   return (channel << 1) | (scan_discard ? 0 : ADC_SLOT_KEEP);
 }
\ No newline at end of file
@@ -1,125 +1,516 @@
-/********************************************************************************
-* adc.h: Innehller funktionalitet fr enkel implementering av AD-omvandling
-*        fr analoga signaler via strukten adc. AD-omvandling sker via inlsning
-*        av signaler frn analoga pinnar A0 - A5 p  Arduino Uno, vilket
-*        motsvarar PORTC0 - PORTC5 p ATmega328P.
-*
-*        Analoga insignaler mellan 0 - 5 V AD-omvandlas till digitala
-*        motsvarigheter mellan 0 - 1023. Duty cycle kan anvndas fr
-*        PWM-generering och berknas enligt nedan:
-*
-*                       duty cycle = ADC_result / ADC_MAX,
-*
-*       dr ADC_result r resultat avlst frn AD-omvandlaren OCH ADC_MAX
-*       utgr hgsta mjliga avlsta vrde, vilket r 1023.0.
-********************************************************************************/
-#ifndef ADC_H_
-#define ADC_H_
-
-/* Inkluderingsdirektiv: */
-#include "misc.h"
-
-/* Makrodefinitioner: */
-#define ADC_MAX 1023.0 /* Hgsta digitala vrde vid AD-omvandling (motsvarar 5 V). */
-#define VCC 5.0        /* 5 V matningsspnning. */
-
-/********************************************************************************
-* adc: Strukt fr implementering av AD-omvandlare, som mjliggr avlsning
-*      av insignaler frn analoga pinnar samt berkning av on- och off-tid fr
-*      PWM-generering (tiden som PWM-styrd utsignal ska vara hg respektive lg).
-********************************************************************************/
-struct adc
-{
-   uint8_t pin;         /* Analog pin som ska anvndas fr avlsning. */
-   uint16_t pwm_on_us;  /* On-tid fr PWM-generering i mikrosekunder. */
-   uint16_t pwm_off_us; /* Off-tid fr PWM-generering i mikrosekunder. */
-};
-
-/********************************************************************************
-* adc_init: Initierar analog pin fr avlsning och AD-omvandling av insignaler,
-*           som antingen kan anges som ett tal mellan 0 - 5 eller via konstanter
-*           A0 - A5 (som motsvarar heltal 14 - 19).
-*
-*           - self: Pekare till analog pin som ska anvndas fr AD-omvandling.
-*           - pin : Analog pin som ska lsas fr AD-omvandling.
-********************************************************************************/
-void adc_init(struct adc* self,
-              const uint8_t pin);
-
-/********************************************************************************
-* adc_clear: Nollstller angivet adc-objekt.
-*
-*            - self: Pekare till objektet som ska nollstllas.
-********************************************************************************/
-static inline void adc_clear(struct adc* self)
-{
-   self->pin = 0;
-   self->pwm_on_us = 0;
-   self->pwm_off_us = 0;
-   return;
-}
-
-/********************************************************************************
-* adc_read: Lser av en analog insignal och returnerar motsvarande digitala
-*           motsvarighet mellan 0 - 1023.
-*
-*           - self: Pekare till analog pin vars insignal ska AD-omvandlas.
-********************************************************************************/
-uint16_t adc_read(const struct adc* self);
-
-/********************************************************************************
-* adc_duty_cycle: Lser av en analog insignal och returnerar motsvarande
-*                 duty cycle som ett flyttal mellan 0 - 1.
-*
-*                 - self: Pekare till analog pin vars insignal ska AD-omvandlas.
-********************************************************************************/
-static inline double adc_duty_cycle(const struct adc* self)
-{
-   return adc_read(self) / ADC_MAX;
-}
-
-/********************************************************************************
-* adc_get_pwm_values: Lser av en analog insignal och berknar on- och off-tid
-*                     fr PWM-generering, avrundat till nrmaste heltal.
-*
-*                     - self         : Pekare till analog pin som ska lsas av.
-*                     - pwm_period_us: PWM-perioden (on-tid + off-tid) mtt i
-*                                      mikrosekunder (default = 10 000 us).
-********************************************************************************/
-void adc_get_pwm_values(struct adc* self,
-                        uint16_t pwm_period_us);
-
-/********************************************************************************
-* adc_get_input_voltage: Returnerar inspnningen p angiven analog pin genom att
-*                        lsa av insignalen, omvandla till motsvarande digitala
-*                        vrde och sedan berkna motsvarande inspnning.
-*
-*                        Vrdet berknas efter en matningsspnning p 5 V,
-*                        vilket medfr en analog insignal mellan 0 - 5 V. 
-*                        Genom att avlsa duty cycle (mellan 0 - 1) s erhlls 
-*                        motsvarande analoga inspnning Uin, som returneras.
-*     
-*                        - self: Pekare till analog pin som ska lsas av.
-********************************************************************************/
-static inline double adc_get_input_voltage(const struct adc* self)
-{
-   return adc_duty_cycle(self) * VCC;
-}
-
-/********************************************************************************
-* adc_get_temperature: Returnerar aktuell rumstemperatur via avlsning av
-*                      temperatursensor TMP36, ansluten till angiven pin.
-*
-*                      Temperaturen T berknas via fljande formel:
-*                      T = 100 * Uin - 50,
-*                      dr Uin r aktuell analog inspnning avlst frn 
-*                      temperatursensor TMP36.
-*
-*                      - self: Pekare till analog pin som ska lsas av.
-********************************************************************************/
-static inline double adc_get_temperature(const struct adc* self)
-{
-   return 100 * adc_get_input_voltage(self) - 50;
-}
-
+/********************************************************************************
+* adc.h: Innehåller funktionalitet för enkel implementering av AD-omvandling
+*        för analoga signaler via strukten adc. AD-omvandling sker via inläsning
+*        av signaler från analoga pinnar A0 - A5 på  Arduino Uno, vilket
+*        motsvarar PORTC0 - PORTC5 på ATmega328P.
+*
+*        Analoga insignaler mellan 0 - 5 V AD-omvandlas till digitala
+*        motsvarigheter mellan 0 - 2^bits - 1, dvs. 0 - 1023 vid 10 bitar.
+*        Duty cycle kan användas för PWM-generering och beräknas enligt nedan:
+*
+*                       duty cycle = ADC_result / (2^bits - 1),
+*
+*       där ADC_result är resultat avläst från AD-omvandlaren och bits är
+*       aktuell upplösning (8 - 14), vilket ger nämnaren 255 vid 8 bitar
+*       och 16383 vid 14 bitar.
+*
+*       Upplösningen kan ökas till 11 - 14 bitar via översampling (se
+*       adc_set_oversampling), där 4^n resultat ackumuleras och decimeras
+*       till 10 + n bitar. Exempelvis ger 14 bitar ca 0.03 grader per steg
+*       för TMP36 jämfört med ca 0.49 grader vid 10 bitar. Översampling
+*       kräver minst 1 LSB brus på insignalen; saknas brus kan dither
+*       injiceras via en utgång (ADC_DITHER_PIN) som ansluts till insignalen
+*       via ett högohmigt motstånd. Samplingshastigheten delas med 4^n.
+*
+*       Decimerat resultat är summan av 4^n resultat skiftad n steg, varför
+*       högsta möjliga värde blir 1023 * 2^n, inte 2^(10 + n) - 1. Vid full
+*       skala blir resultatet därmed ca 0.1 % (2^n - 1 steg) för lågt,
+*       vilket inte kompenseras. Felet motsvarar knappt 1 LSB vid 10
+*       bitar, men bör beaktas vid kalibrering mot full skala.
+*
+*       Dither-pinnen togglas av programvaran mellan omvandlingarna, utan
+*       någon garanti för när detta sker i förhållande till sample and
+*       hold (1.5 ADC-cykler efter start). Vid kontinuerlig omvandling har
+*       nästa omvandling redan startats när avbrottsrutinen togglar pinnen,
+*       varför nivån kan hinna påverka den pågående omvandlingen eller inte
+*       beroende på avbrottslatens. Dessutom ändras nivån på insignalen
+*       exponentiellt via motståndet. Hög och låg nivå tar därmed endast
+*       ut varandra i genomsnitt, inte exakt i varje utvärde.
+*
+*       För lägre brusgolv kan avläsning ske i ADC Noise Reduction Mode via
+*       adc_read_quiet samt adc_read_quiet_batch, där processorn sover under
+*       omvandlingen och väcks av ADC_vect. Övriga avbrott maskas under
+*       tiden. Observera att I/O-klockan stannar i detta läge, vilket medför
+*       att Timer 0, Timer 1 och Timer 2 (synkront klockad) står stilla.
+*       Systemklockan (se sysclock.h) tappar därmed ca 104 us per omvandling
+*       (13 ADC-cykler vid prescaler 128), debounce- och blinktimers
+*       förlängs lika mycket och tecken som tas emot under tiden går
+*       förlorade. Strömförbrukningen under väntan minskar samtidigt.
+*
+*       För helt jämn sampling (exempelvis inför filtrering eller
+*       spektralanalys) kan omvandlingarna i stället startas av hårdvaran
+*       via adc_trigger_start, där compare match B i Timer 1 används som
+*       triggerkälla. Timer 1 löper fritt som systemets tidsbas, varför
+*       OCR1B flyttas fram en period i avbrottsrutinen. Timer 0 overflow
+*       används inte som triggerkälla, eftersom perioden då endast kan
+*       väljas i steg om 256 räknarsteg. Timer 1 får inte heller tilldelas
+*       en timer via timer.h medan triggning pågår.
+*
+*       Som default sker varje avläsning via en blockerande omvandling, som
+*       tar cirka 104 us. Alternativt kan AD-omvandlaren köras kontinuerligt
+*       i Free Running Mode via adc_scan_start, där angivna kanaler omvandlas
+*       i tur och ordning i avbrottsrutinen för vektorn ADC_vect. Senaste
+*       resultat per kanal lagras då i en cache, varvid adc_read returnerar
+*       direkt utan att vänta på någon omvandling. Ett sekvensnummer per
+*       kanal (se adc_sequence) anger ifall ett nytt resultat har erhållits.
+*
+*       Vid kontinuerlig omvandling omvandlas kanalerna jämnt i tur och
+*       ordning (round robin), där kanal byts i avbrottsrutinen. Varje
+*       resultat lagras även i en ringbuffert per kanal om ADC_BUFFER_SIZE
+*       resultat, som hämtas via adc_buffer_read. Huvudloopen behöver
+*       därmed inte röra AD-omvandlaren alls. Vid högimpediva källor kan
+*       första resultatet efter varje kanalbyte slängas, eftersom
+*       samplingskondensatorn då inte hinner laddas om helt, vilket
+*       halverar samplingshastigheten. Total samplingshastighet erhålls via
+*       adc_scan_rate; per kanal erhålls denna delat på antalet kanaler,
+*       exempelvis ca 1602 Hz per kanal vid sex kanaler utan kasserade
+*       resultat.
+*
+*       Vid blockerande avläsning kan prescaler väljas per adc-objekt via
+*       adc_set_speed, där en omvandling tar 13 cykler av ADC-klockan
+*       (F_CPU / prescaler). Enligt databladet krävs en ADC-klocka på
+*       50 - 200 kHz för full upplösning, medan högre klocka ger sämre
+*       noggrannhet. Ungefärliga värden vid 16 MHz:
+*
+*       Prescaler | ADC-klocka | Omvandling | Hastighet  | Noggrannhet
+*       ----------+------------+------------+------------+------------------
+*       128       | 125 kHz    | 104 us     | 9.6 kS/s   | 10 bitar
+*       64        | 250 kHz    | 52 us      | 19.2 kS/s  | ca 9 - 10 bitar
+*       32        | 500 kHz    | 26 us      | 38.5 kS/s  | ca 8 - 9 bitar
+*       16        | 1 MHz      | 13 us      | 76.9 kS/s  | ca 8 bitar
+*       8         | 2 MHz      | 6.5 us     | 154 kS/s   | under 8 bitar
+*       4, 2      | 4 - 8 MHz  | < 4 us     | > 300 kS/s | rekommenderas ej
+*
+*       Då 8 bitar räcker (exempelvis potentiometer till PWM eller
+*       tröskeldetektering) kan resultatet vänsterjusteras (ADLAR), så att
+*       endast ADCH behöver läsas. Med prescaler 32 eller 16 erhålls då 4 - 8
+*       gånger högre samplingshastighet än default. Hastigheten inkluderar
+*       inte tid för funktionsanrop. Kontinuerlig och triggad omvandling
+*       använder alltid prescaler 128 och full upplösning.
+*
+*       Härledda värden kan beräknas med heltal utan flyttal, som på AVR
+*       emuleras i mjukvara (32 bitar) och kostar hundratals klockcykler per
+*       operation. Duty cycle anges då i Q0.16-format (0 - 65535, där 65535
+*       motsvarar 100 %), inspänning i millivolt och temperatur i
+*       hundradels grader. Samtliga beräkningar sker via multiplikation och
+*       skift. Funktionerna som returnerar flyttal utgör omslag kring dessa.
+********************************************************************************/
+#ifndef ADC_H_
+#define ADC_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+
+/* Makrodefinitioner: */
+#define ADC_RESOLUTION 10 /* AD-omvandlarens upplösning i bitar utan översampling. */
+#define ADC_OVERSAMPLING_MAX 4 /* Maximalt antal extra bitar via översampling (14 bitar). */
+
+#define ADC_TRIGGER_PERIOD_MIN_US 200 /* Kortaste period vid triggning (omvandling ca 108 us plus marginal). */
+#define ADC_TRIGGER_PERIOD_MAX_US 1000000UL /* Längsta period vid triggning (1 s). */
+
+#ifndef ADC_DITHER_PIN
+#define ADC_DITHER_PIN D7 /* Utgång för dither vid översampling (pin 7). */
+#endif
+#define VCC 5.0        /* 5 V matningsspänning. */
+#define ADC_VCC_MV 5000 /* Matningsspänning i millivolt. */
+#define ADC_Q16_MAX 0xFFFF /* Duty cycle 100 % i Q0.16-format. */
+#define ADC_CHANNELS 6 /* Antal analoga kanaler (A0 - A5). */
+
+#ifndef ADC_BUFFER_SIZE
+#define ADC_BUFFER_SIZE 8 /* Storlek på ringbuffert per kanal (jämn tvåpotens, rymmer en mindre). */
+#endif
+
+_Static_assert(ADC_BUFFER_SIZE >= 2 && ADC_BUFFER_SIZE <= 256 &&
+               (ADC_BUFFER_SIZE & (ADC_BUFFER_SIZE - 1)) == 0,
+               "ADC_BUFFER_SIZE must be a power of two between 2 and 256!");
+
+/********************************************************************************
+* adc_prescaler: Enumeration för val av prescaler för ADC-klockan, där
+*                värdet utgör bitarna ADPS2 - ADPS0 i ADCSRA.
+********************************************************************************/
+enum adc_prescaler
+{
+   ADC_PRESCALER_2 = 1,  /* 8 MHz, rekommenderas ej. */
+   ADC_PRESCALER_4 = 2,  /* 4 MHz, rekommenderas ej. */
+   ADC_PRESCALER_8 = 3,  /* 2 MHz, under 8 bitars noggrannhet. */
+   ADC_PRESCALER_16 = 4, /* 1 MHz, ca 8 bitar. */
+   ADC_PRESCALER_32 = 5, /* 500 kHz, ca 8 - 9 bitar. */
+   ADC_PRESCALER_64 = 6, /* 250 kHz, ca 9 - 10 bitar. */
+   ADC_PRESCALER_128 = 7 /* 125 kHz, 10 bitar (default). */
+};
+
+/********************************************************************************
+* adc: Strukt för implementering av AD-omvandlare, som möjliggör avläsning
+*      av insignaler från analoga pinnar samt beräkning av on- och off-tid för
+*      PWM-generering (tiden som PWM-styrd utsignal ska vara hög respektive låg).
+********************************************************************************/
+struct adc
+{
+   uint8_t pin;            /* Analog pin som ska användas för avläsning. */
+   uint16_t pwm_on_us;     /* On-tid för PWM-generering i mikrosekunder. */
+   uint16_t pwm_off_us;    /* Off-tid för PWM-generering i mikrosekunder. */
+   uint8_t prescaler_bits; /* Bitar ADPS2 - ADPS0 vid blockerande avläsning. */
+   bool eight_bit;         /* Indikerar 8-bitars avläsning via ADLAR. */
+};
+
+/********************************************************************************
+* adc_init: Initierar analog pin för avläsning och AD-omvandling av insignaler,
+*           som antingen kan anges som ett tal mellan 0 - 5 eller via konstanter
+*           A0 - A5 (som motsvarar heltal 14 - 19).
+*
+*           - self: Pekare till analog pin som ska användas för AD-omvandling.
+*           - pin : Analog pin som ska läsas för AD-omvandling.
+********************************************************************************/
+void adc_init(struct adc* self,
+              const uint8_t pin);
+
+/********************************************************************************
+* adc_clear: Nollställer angivet adc-objekt.
+*
+*            - self: Pekare till objektet som ska nollställas.
+********************************************************************************/
+static inline void adc_clear(struct adc* self)
+{
+   self->pin = 0;
+   self->pwm_on_us = 0;
+   self->pwm_off_us = 0;
+   self->prescaler_bits = ADC_PRESCALER_128;
+   self->eight_bit = false;
+   return;
+}
+
+/********************************************************************************
+* adc_set_speed: Sätter prescaler samt upplösning vid blockerande avläsning
+*                av angivet adc-objekt, se tabellen ovan. Vid 8 bitar
+*                vänsterjusteras resultatet och endast ADCH läses, där
+*                översampling inte används. Under kontinuerlig omvandling
+*                skiftas resultatet från cachen i stället ned till 8 bitar.
+*
+*                - self     : Pekare till adc-objektet.
+*                - prescaler: Prescaler för ADC-klockan.
+*                - eight_bit: Indikerar ifall 8-bitars avläsning ska användas.
+********************************************************************************/
+static inline void adc_set_speed(struct adc* self,
+                                 const enum adc_prescaler prescaler,
+                                 const bool eight_bit)
+{
+   self->prescaler_bits = (uint8_t)prescaler;
+   self->eight_bit = eight_bit;
+   return;
+}
+
+/********************************************************************************
+* adc_read: Läser av en analog insignal och returnerar motsvarande digitala
+*           motsvarighet mellan 0 - 2^bits - 1. Ifall kontinuerlig
+*           omvandling pågår (se adc_scan_start) returneras senaste resultat
+*           för kanalen utan väntan, annars genomförs en blockerande
+*           omvandling. Kanaler som inte ingår i en pågående kontinuerlig
+*           omvandling returnerar senast lagrade resultat (0 ifall kanalen
+*           aldrig har omvandlats).
+*
+*           - self: Pekare till analog pin vars insignal ska AD-omvandlas.
+********************************************************************************/
+uint16_t adc_read(const struct adc* self);
+
+/********************************************************************************
+* adc_sequence: Returnerar sekvensnumret för senaste resultat på angiven
+*               kanal, som räknas upp (och slår runt) vid varje nytt resultat
+*               under kontinuerlig omvandling. Genom att jämföra med ett
+*               tidigare avläst sekvensnummer kan anroparen avgöra ifall
+*               resultatet är nytt samt hur många resultat som har erhållits.
+*
+*               - self: Pekare till analog pin vars sekvensnummer ska läsas.
+********************************************************************************/
+uint8_t adc_sequence(const struct adc* self);
+
+/********************************************************************************
+* adc_scan_start: Startar kontinuerlig omvandling av angivna kanaler i Free
+*                 Running Mode, där kanalerna omvandlas i tur och ordning i
+*                 avbrottsrutinen för vektorn ADC_vect. Med prescaler 128
+*                 erhålls cirka 9600 resultat per sekund totalt, fördelat
+*                 jämnt över kanalerna. Eventuell pågående omvandling stoppas
+*                 och ringbuffertarna töms först.
+*
+*                 - channel_mask: Bitmask med en bit per kanal A0 - A5, där
+*                                 bit 0 motsvarar A0. 0 stoppar omvandlingen.
+*                 - discard     : Indikerar ifall första resultatet efter
+*                                 varje kanalbyte ska slängas (halverar
+*                                 samplingshastigheten).
+********************************************************************************/
+void adc_scan_start(const uint8_t channel_mask,
+                    const bool discard);
+
+/********************************************************************************
+* adc_trigger_start: Startar omvandling av angivna kanaler med fast
+*                    samplingsperiod, där varje omvandling startas av
+*                    hårdvaran vid compare match B i Timer 1. Kanalerna
+*                    omvandlas i tur och ordning, en per period, varför
+*                    perioden per kanal utgörs av angiven period gånger
+*                    antalet kanaler. Resultaten lagras i cachen samt
+*                    ringbuffertarna precis som vid adc_scan_start.
+*                    Eventuell pågående omvandling stoppas först.
+*
+*                    - channel_mask: Bitmask med en bit per kanal A0 - A5.
+*                    - discard     : Indikerar ifall första resultatet efter
+*                                    varje kanalbyte ska slängas.
+*                    - period_us   : Tid mellan omvandlingarna i mikrosekunder
+*                                    (ADC_TRIGGER_PERIOD_MIN_US - 
+*                                    ADC_TRIGGER_PERIOD_MAX_US).
+********************************************************************************/
+void adc_trigger_start(const uint8_t channel_mask,
+                       const bool discard,
+                       uint32_t period_us);
+
+/********************************************************************************
+* adc_trigger_misses: Returnerar antalet missade compare-tillfällen sedan
+*                     start, exempelvis på grund av långa avbrottsrutiner.
+********************************************************************************/
+uint16_t adc_trigger_misses(void);
+
+/********************************************************************************
+* adc_scan_stop: Stoppar kontinuerlig eller triggad omvandling, varefter
+*                avläsningar åter sker via blockerande omvandling. Senaste
+*                resultat behålls.
+********************************************************************************/
+void adc_scan_stop(void);
+
+/********************************************************************************
+* adc_scan_running: Indikerar ifall kontinuerlig omvandling pågår.
+********************************************************************************/
+bool adc_scan_running(void);
+
+/********************************************************************************
+* adc_scan_rate: Returnerar antalet lagrade resultat per sekund totalt under
+*                kontinuerlig omvandling (0 ifall ingen omvandling pågår).
+*                Samplingshastigheten per kanal utgörs av detta delat på
+*                antalet kanaler.
+********************************************************************************/
+uint16_t adc_scan_rate(void);
+
+/********************************************************************************
+* adc_buffer_read: Hämtar äldsta ohämtade resultat ur angiven kanals
+*                  ringbuffert. Returnerar false ifall bufferten är tom.
+*
+*                  - self : Pekare till analog pin vars resultat ska hämtas.
+*                  - value: Pekare till variabel där resultatet lagras.
+********************************************************************************/
+bool adc_buffer_read(const struct adc* self,
+                     uint16_t* value);
+
+/********************************************************************************
+* adc_buffer_count: Returnerar antalet ohämtade resultat i angiven kanals
+*                   ringbuffert.
+*
+*                   - self: Pekare till analog pin vars ringbuffert ska läsas.
+********************************************************************************/
+uint8_t adc_buffer_count(const struct adc* self);
+
+/********************************************************************************
+* adc_buffer_overruns: Returnerar antalet resultat som har skrivits över
+*                      innan de hämtades (summerat över samtliga kanaler),
+*                      eftersom ringbufferten var full.
+********************************************************************************/
+uint16_t adc_buffer_overruns(void);
+
+/********************************************************************************
+* adc_set_oversampling: Sätter antalet extra bitar via översampling, där 4^n
+*                       resultat ackumuleras per utvärde och decimeras till
+*                       10 + n bitar. Vid kontinuerlig omvandling sker
+*                       ackumuleringen i avbrottsrutinen, annars genomförs
+*                       4^n blockerande omvandlingar per avläsning.
+*                       Ringbuffertarna töms vid ändring.
+*
+*                       Högsta decimerade resultat är 1023 * 2^n, se ovan.
+*
+*                       - bits      : Antal extra bitar (0 - 4), där 0
+*                                     inaktiverar översampling.
+*                       - use_dither: Indikerar ifall ADC_DITHER_PIN ska
+*                                     sättas till utgång och togglas mellan
+*                                     omvandlingarna (utan garanterad
+*                                     tidpunkt relativt sample and hold).
+********************************************************************************/
+void adc_set_oversampling(uint8_t bits,
+                          const bool use_dither);
+
+/********************************************************************************
+* adc_resolution: Returnerar aktuell upplösning i bitar (10 - 14).
+********************************************************************************/
+uint8_t adc_resolution(void);
+
+/********************************************************************************
+* adc_read_quiet: Läser av en analog insignal via omvandling i ADC Noise
+*                 Reduction Mode och returnerar resultatet (0 - 2^bits - 1).
+*                 Får inte anropas från en avbrottsrutin.
+*
+*                 - self: Pekare till analog pin som ska läsas av.
+********************************************************************************/
+uint16_t adc_read_quiet(const struct adc* self);
+
+/********************************************************************************
+* adc_read_quiet_batch: Genomför angivet antal avläsningar i följd i ADC Noise
+*                       Reduction Mode, där övriga avbrott maskas en gång för
+*                       hela serien. Tidigare avbrottsmasker, sleep mode samt
+*                       avbrottsstatus återställs efteråt. Timer 0 - 2 står
+*                       stilla under hela serien. Under kontinuerlig omvandling
+*                       returneras i stället senaste resultat från cachen.
+*                       Får inte anropas från en avbrottsrutin.
+*
+*                       - self  : Pekare till analog pin som ska läsas av.
+*                       - values: Pekare till array där resultaten lagras.
+*                       - count : Antal avläsningar som ska genomföras.
+********************************************************************************/
+void adc_read_quiet_batch(const struct adc* self,
+                          uint16_t* values,
+                          const uint8_t count);
+
+/********************************************************************************
+* adc_scale_q16: Skalar ett resultat med angiven upplösning till Q0.16-format
+*                via bitreplikering, dvs. resultatet skiftas upp till 16 bitar
+*                och de lägsta bitarna fylls med resultatets högsta bitar.
+*                Detta motsvarar result * 65535 / (2^bits - 1) med ett fel
+*                under en LSB, där högsta resultat ger exakt 65535.
+*
+*                - result: Resultat från AD-omvandlaren.
+*                - bits  : Resultatets upplösning i bitar (8 - 14).
+********************************************************************************/
+static inline uint16_t adc_scale_q16(const uint16_t result,
+                                     const uint8_t bits)
+{
+   return (result << (16 - bits)) | (result >> (2 * bits - 16));
+}
+
+/********************************************************************************
+* adc_duty_cycle_q16: Läser av en analog insignal och returnerar motsvarande
+*                     duty cycle i Q0.16-format (0 - 65535).
+*
+*                     - self: Pekare till analog pin som ska läsas av.
+********************************************************************************/
+static inline uint16_t adc_duty_cycle_q16(const struct adc* self)
+{
+   const uint8_t bits = self->eight_bit ? 8 : adc_resolution();
+   return adc_scale_q16(adc_read(self), bits);
+}
+
+/********************************************************************************
+* adc_duty_cycle: Läser av en analog insignal och returnerar motsvarande
+*                 duty cycle som ett flyttal mellan 0 - 1.
+*
+*                 - self: Pekare till analog pin vars insignal ska AD-omvandlas.
+********************************************************************************/
+static inline double adc_duty_cycle(const struct adc* self)
+{
+   return adc_duty_cycle_q16(self) / (double)ADC_Q16_MAX;
+}
+
+/********************************************************************************
+* adc_get_pwm_values: Läser av en analog insignal och beräknar on- och off-tid
+*                     för PWM-generering, avrundat till närmaste heltal.
+*
+*                     - self         : Pekare till analog pin som ska läsas av.
+*                     - pwm_period_us: PWM-perioden (on-tid + off-tid) mätt i
+*                                      mikrosekunder (default = 10 000 us).
+********************************************************************************/
+void adc_get_pwm_values(struct adc* self,
+                        uint16_t pwm_period_us);
+
+/********************************************************************************
+* adc_millivolts_from_q16: Beräknar inspänningen i millivolt (0 - 5000)
+*                          utifrån duty cycle i Q0.16-format, avrundat till
+*                          närmaste heltal. Beräknas som duty cycle gånger
+*                          ADC_VCC_MV, skiftat 16 steg åt höger.
+*
+*                          - duty_q16: Duty cycle i Q0.16-format.
+********************************************************************************/
+static inline uint16_t adc_millivolts_from_q16(const uint16_t duty_q16)
+{
+   return (uint16_t)(((uint32_t)duty_q16 * ADC_VCC_MV + 0x8000) >> 16);
+}
+
+/********************************************************************************
+* adc_get_input_millivolts: Returnerar inspänningen på angiven analog pin i
+*                           millivolt (0 - 5000), avrundat till närmaste
+*                           heltal, se adc_millivolts_from_q16.
+*
+*                           - self: Pekare till analog pin som ska läsas av.
+********************************************************************************/
+static inline uint16_t adc_get_input_millivolts(const struct adc* self)
+{
+   return adc_millivolts_from_q16(adc_duty_cycle_q16(self));
+}
+
+/********************************************************************************
+* adc_get_input_voltage: Returnerar inspänningen på angiven analog pin genom att
+*                        läsa av insignalen, omvandla till motsvarande digitala
+*                        värde och sedan beräkna motsvarande inspänning.
+*
+*                        Värdet beräknas efter en matningsspänning på 5 V,
+*                        vilket medför en analog insignal mellan 0 - 5 V. 
+*                        Genom att avläsa duty cycle (mellan 0 - 1) så erhålls 
+*                        motsvarande analoga inspänning Uin, som returneras.
+*     
+*                        - self: Pekare till analog pin som ska läsas av.
+********************************************************************************/
+static inline double adc_get_input_voltage(const struct adc* self)
+{
+   return adc_duty_cycle(self) * VCC;
+}
+
+/********************************************************************************
+* adc_temperature_centi_from_q16: Beräknar temperaturen för temperatursensor
+*                                 TMP36 i hundradels grader utifrån duty cycle
+*                                 i Q0.16-format. Eftersom T = 100 * Uin - 50
+*                                 gäller T * 100 = duty * 50 000 - 5000, där
+*                                 duty * 50 000 beräknas via multiplikation
+*                                 och skift. Temperaturer över 327.67 grader
+*                                 (inspänning över ca 3.8 V, utanför sensorns
+*                                 område) begränsas till INT16_MAX.
+*
+*                                 - duty_q16: Duty cycle i Q0.16-format.
+********************************************************************************/
+static inline int16_t adc_temperature_centi_from_q16(const uint16_t duty_q16)
+{
+   const uint16_t scaled = (uint16_t)(((uint32_t)duty_q16 * 50000 + 0x8000) >> 16);
+   if (scaled > INT16_MAX + 5000U) return INT16_MAX;
+   return (int16_t)(scaled - 5000);
+}
+
+/********************************************************************************
+* adc_get_temperature_centi: Returnerar aktuell rumstemperatur i hundradels
+*                            grader via avläsning av temperatursensor TMP36,
+*                            ansluten till angiven pin, exempelvis 2345 för
+*                            23.45 grader.
+*
+*                            - self: Pekare till analog pin som ska läsas av.
+********************************************************************************/
+static inline int16_t adc_get_temperature_centi(const struct adc* self)
+{
+   return adc_temperature_centi_from_q16(adc_duty_cycle_q16(self));
+}
+
+/********************************************************************************
+* adc_get_temperature: Returnerar aktuell rumstemperatur via avläsning av
+*                      temperatursensor TMP36, ansluten till angiven pin.
+*
+*                      Temperaturen T beräknas via följande formel:
+*                      T = 100 * Uin - 50,
+*                      där Uin är aktuell analog inspänning avläst från 
+*                      temperatursensor TMP36.
+*
+*                      - self: Pekare till analog pin som ska läsas av.
+********************************************************************************/
+static inline double adc_get_temperature(const struct adc* self)
+{
+   return adc_get_temperature_centi(self) / 100.0;
+}
+
 #endif /* ADC_H_ */
\ No newline at end of file
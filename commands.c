@@ -0,0 +1,775 @@
+/********************************************************************************
+* commands.c: Innehåller kommandotabellen för kommandoskalet (se shell.h),
+*             som möjliggör avläsning samt ändring av systemets inställningar
+*             via seriell terminal utan omprogrammering.
+********************************************************************************/
+#include "header.h"
+#include "adc.h"
+#include "isr_probe.h"
+#include "sysclock.h"
+
+/* Makrodefinitioner: */
+#define BENCH_RUNS 16 /* Antal anrop per mätning i kommandot bench. */
+
+#ifndef BENCH_SPRINTF
+#define BENCH_SPRINTF 0 /* 1 för att även mäta sprintf i bench fmt (länkar in vfprintf). */
+#endif
+
+/********************************************************************************
+* BENCH: Mäter genomsnittlig exekveringstid för angiven sats i klockcykler via
+*        tidsbasen (se sysclock_cycles) och skriver ut resultatet. Satsen
+*        körs BENCH_RUNS gånger, varefter uppmätt tid för en tom loop dras
+*        av. Sändbufferten töms först, så att sändavbrott inte stör mätningen.
+*
+*        - name     : Namn som skrivs ut före resultatet.
+*        - statement: Satsen som ska mätas.
+********************************************************************************/
+#define BENCH(name, statement) \
+   do \
+   { \
+      serial_flush(); \
+      const uint32_t bench_start = sysclock_cycles(); \
+      for (uint8_t bench_i = 0; bench_i < BENCH_RUNS; ++bench_i) { statement; } \
+      bench_print(PSTR(name), sysclock_cycles() - bench_start); \
+   } while (0)
+
+/* Statiska variabler: */
+static uint16_t wdt_timeout_ms = 8192; /* Aktuell timeout för Watchdog-timern. */
+static uint32_t bench_overhead = 0;    /* Uppmätt tid för en tom loop i kommandot bench. */
+static uint8_t pwm_percent = 0;        /* Aktuell duty cycle för PWM-kontroller p1 i procent. */
+
+#if ISR_PROBE_ENABLED
+#define WHEEL_BENCH_TIMERS_MAX 24 /* Maximalt antal testtimers för kommandot wheel. */
+static struct soft_timer wheel_bench_timers[WHEEL_BENCH_TIMERS_MAX]; /* Testtimers för mätning. */
+static uint8_t wheel_bench_count = 0; /* Antalet aktiverade testtimers. */
+#endif
+
+/* Statiska funktioner: */
+static void timer_command(uint8_t argc, char** argv);
+static void wdt_command(uint8_t argc, char** argv);
+static void adc_command(uint8_t argc, char** argv);
+static void pwm_command(uint8_t argc, char** argv);
+static void scan_command(uint8_t argc, char** argv);
+static void trig_command(uint8_t argc, char** argv);
+static void res_command(uint8_t argc, char** argv);
+static void stats_command(uint8_t argc, char** argv);
+static void log_command(uint8_t argc, char** argv);
+static void bench_command(uint8_t argc, char** argv);
+static void bench_print(PGM_P name, const uint32_t cycles);
+static void bench_timer(void);
+static void bench_event(void);
+static void bench_fmt(void);
+static void bench_q16(void);
+static void bench_output(void* arg);
+static void print_timer_stats(const uint8_t index);
+#if ISR_PROBE_ENABLED
+static void wheel_command(uint8_t argc, char** argv);
+static void wheel_bench_callback(void* arg);
+#endif
+
+/* Hjälptexter för kommandona (lagras i programminnet): */
+static const char timer_usage[] PROGMEM = "timer <0|1> [ms]  : read or set period of t0 (debounce) or t1 (blink)";
+static const char wdt_usage[] PROGMEM   = "wdt [ms]          : read or set watchdog timeout (16 - 8192 ms)";
+static const char adc_usage[] PROGMEM   = "adc [0-5] [d] [8] : read or select channel A0 - A5, optionally with prescaler d (2-128) and 8 bits";
+static const char pwm_usage[] PROGMEM   = "pwm [duty]        : read or set non-blocking PWM duty cycle of led l1 (0-100 %, 0 = off)";
+static const char scan_usage[] PROGMEM  = "scan [mask] [0|1] : read or set scanned channels (0-63, 0 = off), discard first sample";
+static const char trig_usage[] PROGMEM  = "trig <mask> <us>  : sample channels (0-63) every <us> via Timer 1 compare B";
+static const char res_usage[] PROGMEM   = "res [bits] [0|1]  : read or set ADC resolution (10-14 bits) via oversampling, dither";
+static const char stats_usage[] PROGMEM = "stats             : print task, timer, ISR, serial and log statistics";
+static const char log_usage[] PROGMEM   = "log [module 0-4]  : read or set runtime log level of a module";
+static const char bench_usage[] PROGMEM = "bench <group>     : print cycles per call for a group (timer, event, fmt, q16)";
+#if ISR_PROBE_ENABLED
+static const char wheel_usage[] PROGMEM = "wheel <0-24>      : arm dummy soft timers and reset ISR statistics (see stats)";
+#endif
+
+/* Kommandotabell: */
+static const struct shell_command commands[] =
+{
+   { "timer", timer_usage, timer_command },
+   { "wdt",   wdt_usage,   wdt_command },
+   { "adc",   adc_usage,   adc_command },
+   { "pwm",   pwm_usage,   pwm_command },
+   { "scan",  scan_usage,  scan_command },
+   { "trig",  trig_usage,  trig_command },
+   { "res",   res_usage,   res_command },
+   { "stats", stats_usage, stats_command },
+   { "log",   log_usage,   log_command },
+   { "bench", bench_usage, bench_command },
+#if ISR_PROBE_ENABLED
+   { "wheel", wheel_usage, wheel_command }
+#endif
+};
+
+/********************************************************************************
+* commands_init: Initierar kommandoskalet med kommandotabellen.
+********************************************************************************/
+void commands_init(void)
+{
+   shell_init(commands, sizeof(commands) / sizeof(commands[0]));
+   return;
+}
+
+/********************************************************************************
+* timer_command: Skriver ut eller sätter tiden för timer t0 eller t1. Ny
+*                tid för t0 gäller från nästa nedtryckning, medan t1 startas
+*                om direkt med ny periodtid ifall den redan är aktiverad.
+*                Eftersom t0 och t1 är mjukvarutimers gäller intervallet
+*                1 - SOFT_TIMER_TIME_MAX_MS millisekunder.
+*
+*                - argc: Antalet ord, där argv[1] är timern och argv[2] tiden.
+*                - argv: Orden på kommandoraden.
+********************************************************************************/
+static void timer_command(uint8_t argc, char** argv)
+{
+   uint32_t index, time_ms;
+
+   if (argc < 2 || !shell_parse_unsigned(argv[1], &index) || index > 1)
+   {
+      SERIAL_PRINT_P("Usage: timer <0|1> [ms]\n");
+      return;
+   }
+
+   if (argc >= 3)
+   {
+      if (!shell_parse_unsigned(argv[2], &time_ms) || !time_ms || time_ms > SOFT_TIMER_TIME_MAX_MS)
+      {
+         SERIAL_PRINT_P("Invalid time!\n");
+         return;
+      }
+
+      timer_period_ms[index] = time_ms;
+
+      if (index && soft_timer_active(&t1))
+      {
+         soft_timer_start_periodic(&t1, time_ms);
+      }
+      LOG_INFO(TIMER, "t%u period set to %lu ms", (uint16_t)index, time_ms);
+   }
+
+   SERIAL_PRINT_P("t");
+   serial_print_unsigned(index);
+   SERIAL_PRINT_P(": ");
+   serial_print_unsigned(timer_period_ms[index]);
+   SERIAL_PRINT_P(" ms\n");
+   return;
+}
+
+/********************************************************************************
+* wdt_command: Skriver ut eller sätter timeout för Watchdog-timern. Giltiga
+*              timeouts är tvåpotenser mellan 16 - 8192 ms, där prescaler-
+*              bitarna WDP0 - WDP2 samt WDP3 utgör index 0 - 9. Efter att
+*              en ny timeout har satts återaktiveras Watchdog-avbrott.
+*
+*              - argc: Antalet ord, där argv[1] är eventuell ny timeout.
+*              - argv: Orden på kommandoraden.
+********************************************************************************/
+static void wdt_command(uint8_t argc, char** argv)
+{
+   uint32_t timeout_ms;
+
+   if (argc >= 2)
+   {
+      uint8_t index = 0;
+
+      if (!shell_parse_unsigned(argv[1], &timeout_ms))
+      {
+         timeout_ms = 0;
+      }
+
+      while (index < 10 && (16UL << index) != timeout_ms)
+      {
+         index++;
+      }
+
+      if (index == 10)
+      {
+         SERIAL_PRINT_P("Invalid timeout!\n");
+         return;
+      }
+
+      wdt_reset();
+      wdt_init((enum wdt_timeout)((index & 0x07) | ((index >> 3) << WDP3)));
+      wdt_enable_interrupt();
+      wdt_timeout_ms = (uint16_t)timeout_ms;
+      LOG_INFO(WDT, "timeout set to %u ms", wdt_timeout_ms);
+   }
+
+   SERIAL_PRINT_P("wdt: ");
+   serial_print_unsigned(wdt_timeout_ms);
+   SERIAL_PRINT_P(" ms\n");
+   return;
+}
+
+/********************************************************************************
+* adc_command: Läser av vald analog kanal och skriver ut resultatet. Vald
+*              kanal utgör insignalen för PWM-kontroller p1 och är A0 vid
+*              start. Ifall en kanal anges väljs denna, eventuellt med
+*              angiven prescaler samt i 8-bitarsläge, och behålls till
+*              nästa gång kommandot anropas.
+*
+*              - argc: Antalet ord, där argv[1] är kanalen, argv[2]
+*                      prescalern (2 - 128) och argv[3] upplösningen (8).
+*              - argv: Orden på kommandoraden.
+********************************************************************************/
+static void adc_command(uint8_t argc, char** argv)
+{
+   uint32_t channel, division = 128, bits = 10;
+   uint8_t prescaler = ADC_PRESCALER_2;
+
+   if ((argc >= 2 && (!shell_parse_unsigned(argv[1], &channel) || channel > 5)) ||
+       (argc >= 3 && !shell_parse_unsigned(argv[2], &division)) ||
+       (argc >= 4 && (!shell_parse_unsigned(argv[3], &bits) || bits != 8)))
+   {
+      SERIAL_PRINT_P("Usage: adc [0-5] [prescaler 2-128] [8]\n");
+      return;
+   }
+
+   while (prescaler < ADC_PRESCALER_128 && (1UL << prescaler) != division)
+   {
+      prescaler++;
+   }
+
+   if ((1UL << prescaler) != division)
+   {
+      SERIAL_PRINT_P("Prescaler must be a power of two between 2 and 128\n");
+      return;
+   }
+
+   if (argc >= 2)
+   {
+      adc_init(&p1.input, (uint8_t)channel);
+      adc_set_speed(&p1.input, (enum adc_prescaler)prescaler, bits == 8);
+      LOG_INFO(ADC, "channel A%u selected", (uint8_t)channel);
+   }
+
+   SERIAL_PRINT_P("A");
+   serial_print_unsigned(p1.input.pin);
+   SERIAL_PRINT_P(": ");
+   serial_print_unsigned(adc_read(&p1.input));
+
+   if (adc_scan_running())
+   {
+      SERIAL_PRINT_P(" (seq ");
+      serial_print_unsigned(adc_sequence(&p1.input));
+      SERIAL_PRINT_P(")");
+   }
+
+   serial_print_new_line();
+   return;
+}
+
+/********************************************************************************
+* pwm_command: Startar PWM-styrning av lysdiod l1 utan blockering med angiven
+*              duty cycle i procent, alternativt skriver ut aktuell duty
+*              cycle. Duty cycle 0 stoppar PWM-styrningen. Efter låsning av
+*              systemet är PWM-kontrollern inaktiverad och kommandot saknar
+*              då verkan.
+*
+*              - argc: Antalet ord, där argv[1] är duty cycle (0 - 100 %).
+*              - argv: Orden på kommandoraden.
+********************************************************************************/
+static void pwm_command(uint8_t argc, char** argv)
+{
+   uint32_t percent;
+
+   if (argc >= 2)
+   {
+      if (!shell_parse_unsigned(argv[1], &percent) || percent > 100)
+      {
+         SERIAL_PRINT_P("Usage: pwm [duty 0-100 %]\n");
+         return;
+      }
+
+      if (percent)
+      {
+         pwm_start(&p1, (uint16_t)((percent * ADC_Q16_MAX + 50) / 100));
+      }
+      else
+      {
+         pwm_stop(&p1);
+      }
+
+      pwm_percent = (uint8_t)percent;
+      LOG_INFO(APP, "pwm duty cycle set to %u percent", pwm_percent);
+   }
+
+   SERIAL_PRINT_P("pwm: ");
+   serial_print_unsigned(pwm_percent);
+   SERIAL_PRINT_P(" % (on ");
+   serial_print_unsigned(p1.on_ms);
+   SERIAL_PRINT_P(" ms, off ");
+   serial_print_unsigned(p1.off_ms);
+   SERIAL_PRINT_P(" ms)\n");
+   return;
+}
+
+/********************************************************************************
+* scan_command: Startar eller stoppar kontinuerlig omvandling av angivna
+*               kanaler, alternativt skriver ut total samplingshastighet samt
+*               antal överskrivna resultat ifall omvandling pågår. Vid stopp
+*               skickas kvarvarande telemetri.
+*
+*               - argc: Antalet ord, där argv[1] är bitmasken för kanalerna
+*                       och argv[2] anger ifall första resultat ska slängas.
+*               - argv: Orden på kommandoraden.
+********************************************************************************/
+static void scan_command(uint8_t argc, char** argv)
+{
+   uint32_t mask, discard = 0;
+
+   if (argc >= 2)
+   {
+      if (!shell_parse_unsigned(argv[1], &mask) || mask > 63 ||
+          (argc >= 3 && (!shell_parse_unsigned(argv[2], &discard) || discard > 1)))
+      {
+         SERIAL_PRINT_P("Usage: scan [mask 0-63] [discard 0|1]\n");
+         return;
+      }
+
+      adc_scan_start((uint8_t)mask, discard);
+      if (!mask) telemetry_flush();
+      LOG_INFO(ADC, "scan mask set to %u", (uint8_t)mask);
+   }
+
+   SERIAL_PRINT_P("scan: ");
+
+   if (adc_scan_running())
+   {
+      serial_print_unsigned(adc_scan_rate());
+      SERIAL_PRINT_P(" samples/s, ");
+      serial_print_unsigned(adc_buffer_overruns());
+      SERIAL_PRINT_P(" overruns, ");
+      serial_print_unsigned(adc_trigger_misses());
+      SERIAL_PRINT_P(" trigger misses\n");
+   }
+   else
+   {
+      SERIAL_PRINT_P("stopped\n");
+   }
+   return;
+}
+
+/********************************************************************************
+* trig_command: Startar omvandling av angivna kanaler med fast samplingsperiod
+*               via Timer 1 och skriver ut total samplingshastighet samt
+*               antal missade compare-tillfällen. Stoppas via "scan 0".
+*
+*               - argc: Antalet ord, där argv[1] är bitmasken för kanalerna,
+*                       argv[2] perioden i mikrosekunder och argv[3] anger
+*                       ifall första resultat ska slängas.
+*               - argv: Orden på kommandoraden.
+********************************************************************************/
+static void trig_command(uint8_t argc, char** argv)
+{
+   uint32_t mask, period_us, discard = 0;
+
+   if (argc < 3 || !shell_parse_unsigned(argv[1], &mask) || mask > 63 ||
+       !shell_parse_unsigned(argv[2], &period_us) ||
+       period_us < ADC_TRIGGER_PERIOD_MIN_US || period_us > ADC_TRIGGER_PERIOD_MAX_US ||
+       (argc >= 4 && (!shell_parse_unsigned(argv[3], &discard) || discard > 1)))
+   {
+      SERIAL_PRINT_P("Usage: trig <mask 0-63> <200-1000000 us> [discard 0|1]\n");
+      return;
+   }
+
+   adc_trigger_start((uint8_t)mask, discard, period_us);
+   LOG_INFO(ADC, "trigger period set to %lu us", period_us);
+
+   SERIAL_PRINT_P("trig: ");
+   serial_print_unsigned(adc_scan_rate());
+   SERIAL_PRINT_P(" samples/s, ");
+   serial_print_unsigned(adc_trigger_misses());
+   SERIAL_PRINT_P(" misses\n");
+   return;
+}
+
+/********************************************************************************
+* res_command: Sätter upplösningen för AD-omvandling via översampling,
+*              alternativt skriver ut aktuell upplösning.
+*
+*              - argc: Antalet ord, där argv[1] är upplösningen i bitar och
+*                      argv[2] anger ifall dither ska användas.
+*              - argv: Orden på kommandoraden.
+********************************************************************************/
+static void res_command(uint8_t argc, char** argv)
+{
+   uint32_t bits, dither = 0;
+
+   if (argc >= 2)
+   {
+      if (!shell_parse_unsigned(argv[1], &bits) || bits < ADC_RESOLUTION ||
+          bits > ADC_RESOLUTION + ADC_OVERSAMPLING_MAX ||
+          (argc >= 3 && (!shell_parse_unsigned(argv[2], &dither) || dither > 1)))
+      {
+         SERIAL_PRINT_P("Usage: res [bits 10-14] [dither 0|1]\n");
+         return;
+      }
+
+      adc_set_oversampling((uint8_t)(bits - ADC_RESOLUTION), dither);
+      LOG_INFO(ADC, "resolution set to %u bits", (uint8_t)bits);
+   }
+
+   SERIAL_PRINT_P("ADC resolution: ");
+   serial_print_unsigned(adc_resolution());
+   SERIAL_PRINT_P(" bits\n");
+   return;
+}
+
+/********************************************************************************
+* stats_command: Skriver ut statistik för tasks, timer t0 och t1,
+*                avbrottsrutiner (ifall instrumenteringen är aktiverad)
+*                samt seriell överföring.
+*
+*                - argc: Används ej.
+*                - argv: Används ej.
+********************************************************************************/
+static void stats_command(uint8_t argc, char** argv)
+{
+   struct serial_tx_stats tx_stats;
+   struct serial_baud baud;
+   (void)argc;
+   (void)argv;
+
+   task_print_stats();
+   print_timer_stats(0);
+   print_timer_stats(1);
+   isr_probe_print();
+
+   serial_get_tx_stats(&tx_stats);
+   SERIAL_PRINT_P("serial: queued ");
+   serial_print_unsigned(tx_stats.queued);
+   SERIAL_PRINT_P(", dropped ");
+   serial_print_unsigned(tx_stats.dropped);
+   SERIAL_PRINT_P(", peak ");
+   serial_print_unsigned(tx_stats.peak);
+   SERIAL_PRINT_P(", rx overruns ");
+   serial_print_unsigned(serial_rx_overruns());
+   SERIAL_PRINT_P(", log dropped ");
+   serial_print_unsigned(log_dropped());
+   serial_print_new_line();
+
+   serial_get_baud(&baud);
+   SERIAL_PRINT_P("baud: ");
+   serial_print_unsigned(baud.achieved);
+   SERIAL_PRINT_P(" (requested ");
+   serial_print_unsigned(baud.requested);
+   SERIAL_PRINT_P(", error ");
+   serial_print_fixed(baud.error_x100, 2);
+   serial_print_string_P(baud.double_speed ? PSTR(" %, U2X)\n") : PSTR(" %)\n"));
+   return;
+}
+
+/********************************************************************************
+* log_command: Skriver ut loggnivåer för samtliga moduler, eller sätter
+*              nivån under körning för angiven modul (se log.h).
+*
+*              - argc: Antalet ord, där argv[1] är modulen och argv[2] nivån.
+*              - argv: Orden på kommandoraden.
+********************************************************************************/
+static void log_command(uint8_t argc, char** argv)
+{
+   enum log_module module;
+   uint32_t level;
+
+   if (argc >= 2)
+   {
+      if (argc < 3 || !log_find_module(argv[1], &module) ||
+          !shell_parse_unsigned(argv[2], &level) || level > LOG_LEVEL_DEBUG)
+      {
+         SERIAL_PRINT_P("Usage: log <app|timer|adc|eeprom|wdt|serial|task> <0-4>\n");
+         return;
+      }
+
+      log_set_level(module, (uint8_t)level);
+   }
+
+   log_print_levels();
+   return;
+}
+
+/********************************************************************************
+* print_timer_stats: Skriver ut statistik för timer t0 eller t1, alltså
+*                    antalet körningar, missade perioder samt fördröjning
+*                    från utgångstid till callback (jitter) i mikrosekunder.
+*                    Ingenting skrivs ut för en timer som ännu inte har
+*                    löpt ut.
+*
+*                    - index: Timern vars statistik ska skrivas ut (0 - 1).
+********************************************************************************/
+static void print_timer_stats(const uint8_t index)
+{
+   const struct soft_timer_stats* stats = index ? &t1.stats : &t0.stats;
+   if (!stats->runs) return;
+
+   SERIAL_PRINT_P("t");
+   serial_print_unsigned(index);
+   SERIAL_PRINT_P(": runs ");
+   serial_print_unsigned(stats->runs);
+   SERIAL_PRINT_P(", overruns ");
+   serial_print_unsigned(stats->overruns);
+   SERIAL_PRINT_P(", lateness min ");
+   serial_print_unsigned(stats->lateness_min_us);
+   SERIAL_PRINT_P(", avg ");
+   serial_print_unsigned(stats->lateness_avg_us);
+   SERIAL_PRINT_P(", max ");
+   serial_print_unsigned(stats->lateness_max_us);
+   SERIAL_PRINT_P(" us\n");
+   return;
+}
+
+/********************************************************************************
+* bench_command: Mäter exekveringstiden på målet för angiven grupp av
+*                funktioner och skriver ut genomsnittlig tid per anrop i
+*                klockcykler. Tiden för en tom loop mäts först och dras av
+*                från varje mätning, se makrot BENCH. Upplösningen är
+*                SYSCLOCK_PRESCALER klockcykler per BENCH_RUNS anrop.
+*
+*                - argc: Antalet ord, där argv[1] är gruppen.
+*                - argv: Orden på kommandoraden.
+********************************************************************************/
+static void bench_command(uint8_t argc, char** argv)
+{
+   void (*group)(void) = 0;
+
+   if (argc >= 2)
+   {
+      if (!strcmp_P(argv[1], PSTR("timer"))) group = bench_timer;
+      else if (!strcmp_P(argv[1], PSTR("event"))) group = bench_event;
+      else if (!strcmp_P(argv[1], PSTR("fmt"))) group = bench_fmt;
+      else if (!strcmp_P(argv[1], PSTR("q16"))) group = bench_q16;
+   }
+
+   if (!group)
+   {
+      SERIAL_PRINT_P("Usage: bench <timer|event|fmt|q16>\n");
+      return;
+   }
+
+   bench_overhead = 0;
+   serial_flush();
+   const uint32_t start = sysclock_cycles();
+   for (uint8_t i = 0; i < BENCH_RUNS; ++i) { asm volatile(""); }
+   bench_overhead = sysclock_cycles() - start;
+
+   group();
+   return;
+}
+
+/********************************************************************************
+* bench_timer: Mäter initiering av en hårdvarutimer via flyttal (timer_init),
+*              heltal (timer_init_ms) samt färdigberäknade inställningar
+*              (timer_init_config med TIMER_CONFIG). Timer 2 används,
+*              eftersom den inte nyttjas av programmet i övrigt, och
+*              nollställs efter mätningen. Indata läses via volatile-
+*              variabler, så att kompilatorn inte kan beräkna resultatet
+*              i förväg.
+********************************************************************************/
+static void bench_timer(void)
+{
+   volatile double time_ms_double = BLINK_PERIOD_MS;
+   volatile uint32_t time_ms = BLINK_PERIOD_MS;
+   struct timer timer;
+
+   BENCH("timer_init", timer_init(&timer, TIMER_SEL_2, time_ms_double));
+   BENCH("timer_init_ms", timer_init_ms(&timer, TIMER_SEL_2, time_ms));
+   BENCH("timer_init_config", timer_init_config(&timer, TIMER_CONFIG(TIMER_SEL_2, BLINK_PERIOD_MS)));
+   timer_clear(&timer);
+   return;
+}
+
+/********************************************************************************
+* bench_event: Jämför kostnaden för att posta en händelse från en
+*              avbrottsrutin (se event.h) med den blockerande utskrift som
+*              avbrottsrutinerna tidigare genomförde, där samma text skrivs
+*              ut och sändbufferten töms innan nästa anrop. Den senare
+*              mätningen motsvarar därmed tiden avbrottsrutinen tidigare
+*              blockerade vid aktuell baudrate.
+*
+*              Händelsen postas med avbrott inaktiverade, likt i en
+*              avbrottsrutin, och hämtas direkt igen. Avbrott hålls
+*              inaktiverade under hela mätningen, som endast genomförs när
+*              kön är tom, så att hämtad händelse alltid är den postade
+*              och inga verkliga händelser går förlorade.
+********************************************************************************/
+static void bench_event(void)
+{
+   struct event event;
+   uint32_t cycles = 0;
+
+   serial_flush();
+   asm("CLI");
+
+   if (!event_pending())
+   {
+      const uint32_t start = sysclock_cycles();
+
+      for (uint8_t i = 0; i < BENCH_RUNS; ++i)
+      {
+         event_post(0xFF, 0);
+         event_get(&event);
+      }
+      cycles = sysclock_cycles() - start;
+   }
+
+   asm("SEI");
+   bench_print(PSTR("event_post+get"), cycles);
+   BENCH("print+flush", SERIAL_PRINT_P("Watchdog timer reset!\n"); serial_flush());
+   return;
+}
+
+/********************************************************************************
+* bench_fmt: Jämför den divisionsfria omvandlingen av heltal till text
+*            (serial_format_unsigned) med divisionsbaserad omvandling via
+*            ultoa, för det största 32-bitars talet samt ett 16-bitars tal.
+*            Endast formateringen mäts, inte överföringen. Om BENCH_SPRINTF
+*            är satt till 1 mäts även sprintf, som utskrifterna tidigare
+*            använde. Skillnaden i programminne mellan en byggnation med
+*            och utan BENCH_SPRINTF (avr-size) motsvarar då kostnaden för
+*            vfprintf, som inte längre länkas in.
+********************************************************************************/
+static void bench_fmt(void)
+{
+   volatile uint32_t number32 = UINT32_MAX;
+   volatile uint16_t number16 = 12345;
+   char s[12];
+
+   BENCH("format_unsigned(32)", serial_format_unsigned(number32, s));
+   BENCH("ultoa(32)", ultoa(number32, s, 10));
+   BENCH("format_unsigned(16)", serial_format_unsigned(number16, s));
+   BENCH("utoa(16)", utoa(number16, s, 10));
+#if BENCH_SPRINTF
+   BENCH("sprintf(32)", sprintf(s, "%lu", (unsigned long)number32));
+   BENCH("sprintf(16)", sprintf(s, "%u", (unsigned)number16));
+#endif
+   return;
+}
+
+/********************************************************************************
+* bench_q16: Jämför beräkningarna bakom flyttalsfunktionerna för AD-omvandling
+*            samt PWM med motsvarande beräkningar i fixpunkt (Q0.16,
+*            millivolt samt hundradels grader), där båda mätningarna skrivs
+*            ut i följd. Beräkningarna utgår från ett fast resultat på 10
+*            bitar (motsvarande ca 25 grader för TMP36), så att mätningen
+*            inte beror på AD-omvandlarens tillstånd eller innehåller någon
+*            omvandling. Funktionerna för TMP36 anropar funktionerna för
+*            AD-omvandling direkt och kostar därmed lika mycket.
+*
+*            PWM mäts med en lokal PWM-kontroller med periodtiden 0 us och
+*            utenheter som inte utför något, så att endast beräkningen av
+*            on- och off-tid mäts, inte själva perioden. Indata läses samt
+*            resultat lagras via volatile-variabler, så att beräkningarna
+*            inte kan göras i förväg eller optimeras bort.
+********************************************************************************/
+static void bench_q16(void)
+{
+   struct pwm pwm = { .period_us = 0, .output_high = bench_output,
+                      .output_low = bench_output, .enabled = true };
+   volatile uint16_t adc_result = 153;
+   volatile double duty_cycle = 0.5;
+   volatile uint16_t duty_q16 = ADC_Q16_MAX / 2;
+   volatile double result_double;
+   volatile int32_t result;
+
+   BENCH("duty_cycle (double)", result_double = adc_result / 1023.0);
+   BENCH("adc_scale_q16", result = adc_scale_q16(adc_result, 10));
+   BENCH("input_voltage (double)", result_double = adc_result / 1023.0 * VCC);
+   BENCH("adc_millivolts_from_q16", result = adc_millivolts_from_q16(adc_scale_q16(adc_result, 10)));
+   BENCH("temperature (double)", result_double = 100 * (adc_result / 1023.0 * VCC) - 50);
+   BENCH("adc_temperature_centi_from_q16",
+         result = adc_temperature_centi_from_q16(adc_scale_q16(adc_result, 10)));
+   BENCH("pwm_run_with_duty_cycle", pwm_run_with_duty_cycle(&pwm, duty_cycle));
+   BENCH("pwm_run_with_duty_cycle_q16", pwm_run_with_duty_cycle_q16(&pwm, duty_q16));
+   (void)result_double;
+   (void)result;
+   return;
+}
+
+/********************************************************************************
+* bench_output: Utenhet för PWM-kontrollern i bench_q16, som inte utför något.
+*
+*               - arg: Används inte.
+********************************************************************************/
+static void bench_output(void* arg)
+{
+   (void)arg;
+   return;
+}
+
+/********************************************************************************
+* bench_print: Skriver ut genomsnittlig tid per anrop för en mätning i
+*              kommandot bench, där tiden för en tom loop har dragits av.
+*
+*              - name  : Mätningens namn (lagrat i programminnet).
+*              - cycles: Total uppmätt tid för BENCH_RUNS anrop i klockcykler.
+********************************************************************************/
+static void bench_print(PGM_P name, const uint32_t cycles)
+{
+   serial_print_string_P(name);
+   SERIAL_PRINT_P(": ");
+   serial_print_unsigned((cycles > bench_overhead ? cycles - bench_overhead : 0) / BENCH_RUNS);
+   SERIAL_PRINT_P(" cycles\n");
+   return;
+}
+
+#if ISR_PROBE_ENABLED
+
+/********************************************************************************
+* wheel_command: Aktiverar angivet antal periodiska testtimers i timerhjulet
+*                och nollställer statistiken för avbrottsrutinerna, så att
+*                kostnaden per timer kan jämföras mellan olika antal timers
+*                (0 - 24) via kommandot stats. Programmet kör timerhjulet i
+*                tickless-läge, där SOFT_TICK aldrig anropas och TIMER1_OVF
+*                samt TIMER1_COMPA tar samma tid oavsett antalet timers.
+*                Kostnaden hamnar i stället i huvudloopen, där SOFT_RUN mäter
+*                hanteringen av utgångna timers och SOFT_NEXT den linjära
+*                sökningen efter närmast utgående timer inför sleep. Timrarna
+*                har periodtider på 2 - 25 ms, vilket sprider dem över
+*                timerhjulets fack.
+*                Tidigare aktiverade testtimers stoppas först, varför
+*                "wheel 0" stoppar samtliga testtimers.
+*
+*                - argc: Antalet ord, där argv[1] är antalet testtimers.
+*                - argv: Orden på kommandoraden.
+********************************************************************************/
+static void wheel_command(uint8_t argc, char** argv)
+{
+   uint32_t count;
+
+   if (argc < 2 || !shell_parse_unsigned(argv[1], &count) || count > WHEEL_BENCH_TIMERS_MAX)
+   {
+      SERIAL_PRINT_P("Usage: wheel <0-24>\n");
+      return;
+   }
+
+   for (uint8_t i = 0; i < wheel_bench_count; ++i)
+   {
+      soft_timer_stop(&wheel_bench_timers[i]);
+   }
+
+   for (uint8_t i = 0; i < count; ++i)
+   {
+      soft_timer_init(&wheel_bench_timers[i], wheel_bench_callback, 0);
+      soft_timer_start_periodic(&wheel_bench_timers[i], 2 + i);
+   }
+
+   wheel_bench_count = (uint8_t)count;
+   isr_probe_reset();
+
+   SERIAL_PRINT_P("wheel: ");
+   serial_print_unsigned(wheel_bench_count);
+   SERIAL_PRINT_P(" dummy timers armed\n");
+   return;
+}
+
+/********************************************************************************
+* wheel_bench_callback: Callbackrutin för testtimers, som inte utför något.
+*
+*                       - arg: Används ej.
+********************************************************************************/
+static void wheel_bench_callback(void* arg)
+{
+   (void)arg;
+   return;
+}
+
+#endif /* ISR_PROBE_ENABLED */
\ No newline at end of file
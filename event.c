@@ -0,0 +1,74 @@
+/********************************************************************************
+* event.c: Innehåller funktionsdefinitioner för händelsekön.
+********************************************************************************/
+#include "event.h"
+
+/* Makrodefinitioner: */
+#define EVENT_QUEUE_MASK (EVENT_QUEUE_SIZE - 1) /* Bitmask för index i kön. */
+
+/* Statiska variabler: */
+static volatile struct event queue[EVENT_QUEUE_SIZE]; /* Ringbuffert för händelser. */
+static volatile uint8_t head = 0;    /* Index där nästa händelse lagras. */
+static volatile uint8_t tail = 0;    /* Index för äldsta ohämtade händelse. */
+static volatile uint8_t dropped = 0; /* Antal förlorade händelser. */
+
+/********************************************************************************
+* event_post: Lägger till en händelse sist i kön. Händelsen skrivs till kön
+*             innan head räknas upp, så att konsumenten aldrig kan läsa en
+*             ofullständig händelse.
+*
+*             - id     : Händelsens id.
+*             - payload: Data tillhörande händelsen.
+********************************************************************************/
+bool event_post(const uint8_t id,
+                const uint16_t payload)
+{
+   const uint8_t index = head;
+   const uint8_t next = (index + 1) & EVENT_QUEUE_MASK;
+
+   if (next == tail)
+   {
+      if (dropped < UINT8_MAX) dropped++;
+      return false;
+   }
+
+   queue[index].id = id;
+   queue[index].payload = payload;
+   head = next;
+   return true;
+}
+
+/********************************************************************************
+* event_get: Hämtar den äldsta händelsen ur kön. Händelsen läses ut innan
+*            tail räknas upp, så att producenten inte kan skriva över den.
+*
+*            - event: Pekare till strukt där hämtad händelse lagras.
+********************************************************************************/
+bool event_get(struct event* event)
+{
+   const uint8_t index = tail;
+
+   if (index == head) return false;
+
+   event->id = queue[index].id;
+   event->payload = queue[index].payload;
+   tail = (index + 1) & EVENT_QUEUE_MASK;
+   return true;
+}
+
+/********************************************************************************
+* event_pending: Indikerar ifall det finns händelser i kön.
+********************************************************************************/
+bool event_pending(void)
+{
+   return head != tail;
+}
+
+/********************************************************************************
+* event_dropped: Returnerar antalet händelser som har förlorats på grund av
+*                att kön var full. Räknaren mättas vid 255.
+********************************************************************************/
+uint8_t event_dropped(void)
+{
+   return dropped;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+/********************************************************************************
+* event.h: Innehåller drivrutiner för en händelsekö, som används för att flytta
+*          tidskrävande arbete (såsom seriell utskrift) från avbrottsrutiner
+*          till huvudloopen.
+*
+*          Kön är en ringbuffert med exakt en producent (avbrottsrutinerna)
+*          och en konsument (huvudloopen). Producenten skriver endast till
+*          head och konsumenten endast till tail, där båda indexen är 8 bitar
+*          och därmed läses samt skrivs i en instruktion. Kön är därmed
+*          låsfri, varför avbrott aldrig behöver inaktiveras. Eftersom
+*          avbrottsrutiner inte avbryter varandra utgör samtliga
+*          avbrottsrutiner tillsammans en och samma producent.
+*
+*          Att posta en händelse tar några tiotal klockcykler, jämfört med
+*          cirka 1 ms per tecken vid blockerande utskrift med 9600 baud.
+*
+*          Exempel på användning:
+*
+*          ISR (WDT_vect)
+*          {
+*             event_post(EVENT_WDT_TIMEOUT, ++num_timeouts);
+*          }
+*
+*          int main(void)
+*          {
+*             struct event event;
+*
+*             while (1)
+*             {
+*                while (event_get(&event))
+*                {
+*                   handle_event(&event);
+*                }
+*             }
+*          }
+********************************************************************************/
+#ifndef EVENT_H_
+#define EVENT_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+
+/* Makrodefinitioner: */
+#define EVENT_QUEUE_SIZE 16 /* Antal platser i kön (måste vara en tvåpotens). */
+
+/********************************************************************************
+* event: Strukt för lagring av en händelse bestående av ett id, vars betydelse
+*        bestäms av applikationen, samt tillhörande data.
+********************************************************************************/
+struct event
+{
+   uint8_t id;       /* Händelsens id. */
+   uint16_t payload; /* Data tillhörande händelsen. */
+};
+
+/********************************************************************************
+* event_post: Lägger till en händelse sist i kön. Funktionen ska anropas från
+*             avbrottsrutiner. Ifall kön är full förloras händelsen, vilket
+*             räknas upp och false returneras, annars returneras true.
+*
+*             - id     : Händelsens id.
+*             - payload: Data tillhörande händelsen.
+********************************************************************************/
+bool event_post(const uint8_t id,
+                const uint16_t payload);
+
+/********************************************************************************
+* event_get: Hämtar den äldsta händelsen ur kön. Funktionen ska anropas från
+*            huvudloopen. Ifall kön är tom returneras false, annars true.
+*
+*            - event: Pekare till strukt där hämtad händelse lagras.
+********************************************************************************/
+bool event_get(struct event* event);
+
+/********************************************************************************
+* event_pending: Indikerar ifall det finns händelser i kön.
+********************************************************************************/
+bool event_pending(void);
+
+/********************************************************************************
+* event_dropped: Returnerar antalet händelser som har förlorats på grund av
+*                att kön var full.
+********************************************************************************/
+uint8_t event_dropped(void);
+
+#endif /* EVENT_H_ */
\ No newline at end of file
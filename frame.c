@@ -0,0 +1,96 @@
+/********************************************************************************
+* frame.c: Innehåller funktionsdefinitioner för överföring av binära ramar.
+********************************************************************************/
+#include "frame.h"
+#include "serial.h"
+#include <util/crc16.h>
+
+/********************************************************************************
+* frame_source: Strukt som beskriver en ram före kodning, så att ramens byte
+*               kan läsas ut i ordning utan att kopieras till en buffert.
+********************************************************************************/
+struct frame_source
+{
+   uint8_t type;        /* Ramens typbyte. */
+   const uint8_t* data; /* Pekare till ramens data. */
+   uint8_t length;      /* Antal byte data. */
+   uint8_t crc[2];      /* CRC-16 över typ och data, little endian. */
+};
+
+/* Statiska funktioner: */
+static inline uint8_t frame_byte(const struct frame_source* self,
+                                 const uint8_t index);
+
+/********************************************************************************
+* frame_send: Skickar angiven data som en ram av angiven typ. Ramen delas upp
+*             i block som avslutas av en nolla (eller slutet av ramen). Varje
+*             block skickas som en kodbyte, som anger blockets längd plus ett,
+*             följt av blockets byte utom nollan. Eftersom ramen är kortare
+*             än 255 byte behövs inga block utan avslutande nolla.
+*
+*             - type  : Ramens typ.
+*             - data  : Pekare till datan som ska skickas.
+*             - length: Antal byte som ska skickas.
+********************************************************************************/
+void frame_send(const enum frame_type type,
+                const uint8_t* data,
+                uint8_t length)
+{
+   struct frame_source source;
+   uint16_t crc = _crc_ccitt_update(0xFFFF, (uint8_t)type);
+   uint8_t start = 0;
+
+   if (length > FRAME_DATA_SIZE_MAX) length = FRAME_DATA_SIZE_MAX;
+
+   for (uint8_t i = 0; i < length; ++i)
+   {
+      crc = _crc_ccitt_update(crc, data[i]);
+   }
+
+   source.type = (uint8_t)type;
+   source.data = data;
+   source.length = length;
+   source.crc[0] = (uint8_t)crc;
+   source.crc[1] = (uint8_t)(crc >> 8);
+
+   const uint8_t total = length + 3;
+   serial_print_char('\0');
+
+   while (1)
+   {
+      uint8_t end = start;
+
+      while (end < total && frame_byte(&source, end))
+      {
+         end++;
+      }
+
+      serial_print_char((char)(end - start + 1));
+
+      for (uint8_t i = start; i < end; ++i)
+      {
+         serial_print_char((char)frame_byte(&source, i));
+      }
+
+      if (end >= total) break;
+      start = end + 1;
+   }
+
+   serial_print_char('\0');
+   return;
+}
+
+/********************************************************************************
+* frame_byte: Returnerar byte på angivet index i ramen före kodning, där
+*             index 0 utgör typbyten, följt av data samt CRC-16.
+*
+*             - self : Pekare till ramen.
+*             - index: Index för byten som ska läsas.
+********************************************************************************/
+static inline uint8_t frame_byte(const struct frame_source* self,
+                                 const uint8_t index)
+{
+   if (!index) return self->type;
+   if (index <= self->length) return self->data[index - 1];
+   return self->crc[index - self->length - 1];
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+/********************************************************************************
+* frame.h: Innehåller drivrutiner för överföring av binära ramar via seriell
+*          överföring, som används av binär telemetri (se telemetry.h) samt
+*          binär loggning (se log.h).
+*
+*          Varje ram består av en typbyte, som anger vilken modul ramen
+*          tillhör, följt av modulens data samt en CRC-16:
+*
+*          [typ (1)] [data (0 - 251)] [CRC-16 (2)]
+*
+*          CRC-16 beräknas över typ och data enligt CRC-CCITT (polynom
+*          0x8408 reflekterat, startvärde 0xFFFF) via _crc_ccitt_update i
+*          avr-libc och lagras little endian. Ramen kodas sedan med COBS
+*          (Consistent Overhead Byte Stuffing), som tar bort samtliga nollor
+*          ur ramen, och skickas mellan två nollor. Mottagaren kan därmed
+*          alltid synkronisera mot nästa nolla, där den inledande nollan
+*          avskiljer ramen från eventuell text som skrivits ut före ramen.
+*          Kodningen sker direkt vid utskrift, utan mellanbuffert.
+*
+*          Ramar kan blandas med vanlig textutskrift på samma port, eftersom
+*          text aldrig innehåller nollor. Text mellan två ramar underkänns
+*          av mottagaren vid CRC-kontroll eller avkodning. Ramar avkodas på
+*          värddatorn via host/frame_decode.h.
+********************************************************************************/
+#ifndef FRAME_H_
+#define FRAME_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+
+/* Makrodefinitioner: */
+#define FRAME_DATA_SIZE_MAX 251 /* Maximal mängd data per ram (totalt högst 254 byte före kodning). */
+
+/********************************************************************************
+* frame_type: Enumeration för typbyten som inleder varje ram.
+********************************************************************************/
+enum frame_type
+{
+   FRAME_TYPE_LOG = 'L',      /* Binär loggning, se log.h. */
+   FRAME_TYPE_TELEMETRY = 'T' /* Binär telemetri, se telemetry.h. */
+};
+
+/********************************************************************************
+* frame_send: Skickar angiven data som en ram av angiven typ. Data utöver
+*             FRAME_DATA_SIZE_MAX byte skickas inte.
+*
+*             - type  : Ramens typ.
+*             - data  : Pekare till datan som ska skickas.
+*             - length: Antal byte som ska skickas.
+********************************************************************************/
+void frame_send(const enum frame_type type,
+                const uint8_t* data,
+                uint8_t length);
+
+#endif /* FRAME_H_ */
\ No newline at end of file
@@ -1,54 +1,104 @@
-/********************************************************************************
-* header.h: Innehllande diverse definitioner samt deklarationer fr
-*           implementering av det inbyggda systemet.
-********************************************************************************/
-#ifndef HEADER_H_
-#define HEADER_H_
-
+/********************************************************************************
+* header.h: Innehållande diverse definitioner samt deklarationer för
+*           implementering av det inbyggda systemet.
+********************************************************************************/
+#ifndef HEADER_H_
+#define HEADER_H_
+
 /* Inkluderingsdirektiv: */
 #include "led.h"
 #include "button.h"
 #include "timer.h"
+#include "soft_timer.h"
+#include "task.h"
 #include "serial.h"
+#include "shell.h"
 #include "eeprom.h"
 #include "wdt.h"
+#include "event.h"
+#include "log.h"
+#include "pwm.h"
+#include "telemetry.h"
 
 /* Makrodefinitioner: */
-#define TIMEOUT_MAX 5       /* Maximalt antal timeouts innan programmet lses. */
+#define TIMEOUT_MAX 5       /* Maximalt antal timeouts innan programmet låses. */
+#define DEBOUNCE_TIME_MS 300 /* Tid som PCI-avbrott är inaktiverade efter nedtryckning. */
+#define BLINK_PERIOD_MS 50   /* Blinkperiod för lysdiod l1 efter låsning av systemet. */
+#define PWM_PERIOD_US 10000  /* Periodtid för PWM-styrning av lysdiod l1 via kommandot pwm. */
+
+/********************************************************************************
+* app_event: Enumeration för händelser som postas från avbrottsrutinerna i
+*            isr.c och hanteras i huvudloopen, se event.h.
+********************************************************************************/
+enum app_event
+{
+   APP_EVENT_WDT_RESET,   /* Watchdog-timern har återställts. */
+   APP_EVENT_WDT_TIMEOUT, /* Watchdog timeout, data utgör antalet timeouts. */
+   APP_EVENT_LOCKDOWN     /* Maximalt antal timeouts, systemet har låsts. */
+};
 
 /* Deklaration av globala objekt: */
 extern struct led l1;
 extern struct button b1;
-extern struct timer t0, t1;
-
-/********************************************************************************
-* setup: Initierar systemet enligt fljande:
-
-*        1. Initierar lysdiod l1 ansluten till pin 8 (PORTB0).
-*
-*        2. Initierar tryckknapp b1 ansluten till pin 13 (PORTB5) och
-*           aktiverar avbrott vid nedtryckning/uppslppning.
-*           Avbrottsvektor fr avbrottsrutinen r PCINT0_vect.
-*
-*        3. Initierar timer t0 till den 8-bitars timerkretsen Timer 0, som
-*           lper ut efter 300 millisekunder efter aktivering i Normal Mode.
-*           Avbrottsvektor fr avbrottsrutinen r TIMER0_OVF_vect.
-*
-*        4. Initierar timer t1 till den 16-bitars timerkretsen Timer 1, som
-*           lper ut efter 50 millisekunder efter aktivering i CTC Mode
-*           (rknar upp till 256 och fungerar drmed som en 8-bitars timer).
-*           Avbrottsvektor fr avbrottsrutinen r TIMER0_COMPA_vect.
-*
-*        5. Initierar seriell verfring med en baud rate p 9600 kbps fr
-*           att mjliggra utskrift till seriell terminal.
-*
-*        6. Skriver startvrdet 0 till adressen 100 i EEPROM-minnet. Denna
-*           adress anvnds fr att lagra antalet passerade Watchdog timeouts.
-*
-*        7. Initierar Watchdog-timern med en timeout p 8192 ms. Avbrott
-*           aktiveras s att timeout medfr avbrott. Avbrottsvektorn fr
-*           motsvarande avbrottsrutin r WDT_vect.
+extern struct soft_timer t0, t1;
+extern struct pwm p1;
+extern struct task debounce_task, lockdown_task;
+extern uint32_t timer_period_ms[2];
+
+/********************************************************************************
+* setup: Initierar systemet enligt följande:
+
+*        1. Initierar lysdiod l1 ansluten till pin 8 (PORTB0).
+*
+*        2. Initierar PWM-kontroller p1 för lysdiod l1 med periodtiden
+*           10 ms och analog insignal A0. PWM-generering startas utan
+*           blockering via kommandot pwm (se commands.c).
+*
+*        3. Initierar tryckknapp b1 ansluten till pin 13 (PORTB5) och
+*           aktiverar avbrott vid nedtryckning/uppsläppning.
+*           Avbrottsvektor för avbrottsrutinen är PCINT0_vect.
+*
+*        4. Initierar timerhjulet för mjukvarutimers i tickless-läge, där
+*           Timer 1 utgör systemets tidsbas (se sysclock.h). I huvudloopen
+*           sover processorn i Idle Mode mellan varje händelse.
+*
+*        5. Initierar mjukvarutimer t0, som återaktiverar PCI-avbrott 300
+*           millisekunder efter nedtryckning, samt mjukvarutimer t1, som
+*           togglar lysdiod l1 var 50:e millisekund efter låsning av
+*           systemet. Timrarna startas av varsin task, som signaleras från
+*           avbrottsrutinerna för PCI-avbrott respektive Watchdog timeout.
+*           Inga timergenererade avbrott utöver tidsbasens används därmed.
+*
+*        6. Initierar schemaläggaren för tasks i huvudloopen, där
+*           händelser postade från avbrottsrutinerna hanteras i en task
+*           som väcks när händelsekön inte är tom (se task.h).
+*
+*        7. Initierar seriell överföring med 9600 baud för
+*           att möjliggöra utskrift till seriell terminal. Mottagna tecken
+*           tolkas av kommandoskalet (se shell.h samt commands.c) i en
+*           task som väcks när tecken har mottagits. Binära loggmeddelanden
+*           (se log.h) skickas i en task som väcks när loggbufferten inte
+*           är tom. Resultat från kontinuerlig eller triggad omvandling
+*           (kommandona scan respektive trig) strömmas som binär telemetri
+*           (se telemetry.h) i en task som väcks när någon kanals
+*           ringbuffert innehåller resultat, där kanalnumret utgör
+*           telemetrikanal.
+*
+*        8. Skriver startvärdet 0 till adressen 100 i EEPROM-minnet. Denna
+*           adress används för att lagra antalet passerade Watchdog timeouts.
+*
+*        9. Initierar Watchdog-timern med en timeout på 8192 ms. Avbrott
+*           aktiveras så att timeout medför avbrott. Avbrottsvektorn för
+*           motsvarande avbrottsrutin är WDT_vect.
 ********************************************************************************/
 void setup(void);
-
+
+/********************************************************************************
+* commands_init: Initierar kommandoskalet med systemets kommandotabell, som
+*                möjliggör avläsning samt ändring av timertider, Watchdog
+*                timeout samt avläsning av analoga kanaler via seriell
+*                terminal. Skriv help för att lista samtliga kommandon.
+********************************************************************************/
+void commands_init(void);
+
 #endif /* HEADER_H_ */
\ No newline at end of file
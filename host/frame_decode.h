@@ -0,0 +1,253 @@
+/********************************************************************************
+* frame_decode.h: Gemensamma funktioner fr avkodning av binra ramar (se
+*                 frame.h) p en Linux-dator, som anvnds av
+*                 telemetry_decode.c samt log_decode.c.
+*
+*                 Data lses frn standard input eller en seriell port.
+*                 Varje ram som avslutas av en nolla COBS-avkodas, varefter
+*                 CRC-16 kontrolleras och ramens typ samt data skickas
+*                 vidare till angiven hanterare. Text mellan ramarna
+*                 (exempelvis frn kommandoskalet) ignoreras, men rknas som
+*                 felaktiga ramar.
+********************************************************************************/
+#ifndef FRAME_DECODE_H_
+#define FRAME_DECODE_H_
+
+/* Krvs fr cfmakeraw, som inte ingr i POSIX. Mste definieras fre
+   samtliga systemheaders, varfr frame_decode.h inkluderas frst. */
+#define _DEFAULT_SOURCE
+
+/* Inkluderingsdirektiv: */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+/* Makrodefinitioner: */
+#define FRAME_SIZE_MAX 256 /* Maximal storlek p en kodad ram. */
+#define FRAME_CRC_SIZE 2   /* Storlek p CRC-16. */
+
+/********************************************************************************
+* frame_stats: Strukt fr lagring av statistik fr mottagna ramar.
+********************************************************************************/
+struct frame_stats
+{
+   unsigned long frames;     /* Antal korrekta ramar. */
+   unsigned long bad_frames; /* Antal ramar med fel (COBS, CRC eller lngd). */
+};
+
+/********************************************************************************
+* frame_handler: Funktionspekare till hanterare fr korrekta ramar.
+*
+*                - type  : Ramens typbyte.
+*                - data  : Pekare till ramens data (utan typ och CRC).
+*                - length: Antal byte data.
+********************************************************************************/
+typedef void (*frame_handler)(const uint8_t type,
+                              const uint8_t* data,
+                              const size_t length);
+
+/********************************************************************************
+* frame_crc_update: Uppdaterar CRC-16 med en byte. Motsvarar
+*                   _crc_ccitt_update i avr-libc.
+*
+*                   - crc : Aktuell CRC.
+*                   - data: Byte som ska lggas till.
+********************************************************************************/
+static inline uint16_t frame_crc_update(uint16_t crc,
+                                        uint8_t data)
+{
+   data ^= (uint8_t)crc;
+   data ^= (uint8_t)(data << 4);
+   return (uint16_t)((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+/********************************************************************************
+* frame_read_le: Lser ett little endian-vrde av angiven storlek.
+*
+*                - data: Pekare till frsta byten.
+*                - size: Antal byte (hgst 4).
+********************************************************************************/
+static inline uint32_t frame_read_le(const uint8_t* data,
+                                     const size_t size)
+{
+   uint32_t value = 0;
+
+   for (size_t i = 0; i < size; ++i)
+   {
+      value |= (uint32_t)data[i] << (8 * i);
+   }
+   return value;
+}
+
+/********************************************************************************
+* frame_cobs_decode: COBS-avkodar en ram (utan avslutande nolla). Returnerar
+*                    antalet avkodade byte, eller -1 ifall ramen r felaktig.
+*
+*                    - in    : Pekare till den kodade ramen.
+*                    - length: Den kodade ramens lngd.
+*                    - out   : Pekare till buffert fr avkodad data.
+********************************************************************************/
+static inline int frame_cobs_decode(const uint8_t* in,
+                                    const size_t length,
+                                    uint8_t* out)
+{
+   size_t i = 0, n = 0;
+
+   while (i < length)
+   {
+      const uint8_t code = in[i++];
+
+      if (!code || i + code - 1 > length) return -1;
+
+      for (uint8_t j = 1; j < code; ++j)
+      {
+         out[n++] = in[i++];
+      }
+
+      if (code < 0xFF && i < length)
+      {
+         out[n++] = 0;
+      }
+   }
+   return (int)n;
+}
+
+/********************************************************************************
+* frame_open: ppnar angiven seriell port i rtt lge med angiven baud rate,
+*             eller standard input ifall ingen port anges. Returnerar
+*             fildeskriptorn, eller -1 vid fel.
+*
+*             - device: Skvg till porten, exempelvis /dev/ttyACM0, eller 0.
+*             - baud  : Baud rate.
+********************************************************************************/
+static inline int frame_open(const char* device,
+                             const long baud)
+{
+   static const struct { long baud; speed_t speed; } speeds[] =
+   {
+      { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 },
+      { 115200, B115200 }, { 230400, B230400 }, { 500000, B500000 }, { 1000000, B1000000 }
+   };
+
+   struct termios options;
+   if (!device) return STDIN_FILENO;
+   const int fd = open(device, O_RDONLY | O_NOCTTY);
+
+   if (fd < 0 || tcgetattr(fd, &options))
+   {
+      perror(device);
+      return -1;
+   }
+
+   cfmakeraw(&options);
+
+   for (size_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); ++i)
+   {
+      if (speeds[i].baud == baud)
+      {
+         cfsetispeed(&options, speeds[i].speed);
+         cfsetospeed(&options, speeds[i].speed);
+         if (!tcsetattr(fd, TCSANOW, &options)) return fd;
+         perror(device);
+         close(fd);
+         return -1;
+      }
+   }
+
+   fprintf(stderr, "unsupported baud rate: %ld\n", baud);
+   close(fd);
+   return -1;
+}
+
+/********************************************************************************
+* frame_check: Kontrollerar CRC-16 fr en avkodad ram och anropar hanteraren
+*              med ramens typ och data ifall ramen r korrekt.
+*
+*              - frame  : Pekare till den avkodade ramen.
+*              - length : Den avkodade ramens lngd.
+*              - handler: Hanterare fr korrekta ramar.
+*              - stats  : Pekare till statistik som uppdateras.
+********************************************************************************/
+static inline void frame_check(const uint8_t* frame,
+                               const size_t length,
+                               frame_handler handler,
+                               struct frame_stats* stats)
+{
+   uint16_t crc = 0xFFFF;
+
+   if (length < 1 + FRAME_CRC_SIZE)
+   {
+      stats->bad_frames++;
+      return;
+   }
+
+   for (size_t i = 0; i < length - FRAME_CRC_SIZE; ++i)
+   {
+      crc = frame_crc_update(crc, frame[i]);
+   }
+
+   if (crc != frame_read_le(frame + length - FRAME_CRC_SIZE, FRAME_CRC_SIZE))
+   {
+      stats->bad_frames++;
+      return;
+   }
+
+   stats->frames++;
+   handler(frame[0], frame + 1, length - 1 - FRAME_CRC_SIZE);
+   return;
+}
+
+/********************************************************************************
+* frame_read: Lser data tills strmmen tar slut och avkodar varje ram som
+*             avslutas av en nolla. Tomma ramar (tv nollor i fljd) ignoreras.
+*
+*             - fd     : Fildeskriptor att lsa frn.
+*             - handler: Hanterare fr korrekta ramar.
+*             - stats  : Pekare till statistik som uppdateras.
+********************************************************************************/
+static inline void frame_read(const int fd,
+                              frame_handler handler,
+                              struct frame_stats* stats)
+{
+   uint8_t encoded[FRAME_SIZE_MAX], decoded[FRAME_SIZE_MAX];
+   uint8_t buffer[256];
+   size_t length = 0;
+   bool overflow = false;
+   ssize_t n;
+
+   while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+   {
+      for (ssize_t i = 0; i < n; ++i)
+      {
+         if (buffer[i])
+         {
+            if (length < sizeof(encoded)) encoded[length++] = buffer[i];
+            else overflow = true;
+            continue;
+         }
+
+         if (overflow)
+         {
+            stats->bad_frames++;
+         }
+         else if (length)
+         {
+            const int size = frame_cobs_decode(encoded, length, decoded);
+            if (size < 0) stats->bad_frames++;
+            else frame_check(decoded, (size_t)size, handler, stats);
+         }
+
+         length = 0;
+         overflow = false;
+      }
+      fflush(stdout);
+   }
+   return;
+}
+
+#endif /* FRAME_DECODE_H_ */
\ No newline at end of file
@@ -0,0 +1,248 @@
+/********************************************************************************
+* log_decode.c: Avkodare fr binr loggning (se log.h), avsedd att kras p
+*               en Linux-dator. Ramar lses antingen frn standard input
+*               eller direkt frn en seriell port och avkodas via
+*               frame_decode.h. Fr varje ram av typen FRAME_TYPE_LOG sls
+*               formatstrngen upp i den ELF-fil som programmerades in i
+*               mikrodatorn, dr meddelandets id utgr formatstrngens
+*               adress i programminnet. Meddelandet formateras sedan med
+*               ramens argument och skrivs ut en per rad.
+*
+*               ELF-filen mste komma frn samma kompilering som krs p
+*               mikrodatorn, annars pekar id:n p fel formatstrngar.
+*               Frlorade meddelanden samt felaktiga ramar rknas och skrivs
+*               ut till standard error. Ramar av andra typer ignoreras.
+*
+*               Kompilering samt exempel p anvndning:
+*
+*               gcc -O2 -o log_decode log_decode.c
+*               ./log_decode "ATmega328P device drivers C - WDT.elf" /dev/ttyACM0 9600
+*               ./log_decode firmware.elf < capture.bin
+********************************************************************************/
+#include "frame_decode.h"
+#include <elf.h>
+
+/* Makrodefinitioner: */
+#define FRAME_TYPE_LOG 'L'         /* Typbyte fr loggramar. */
+#define HEADER_SIZE 3              /* Antal frlorade meddelanden (1) samt id (2). */
+#define FLASH_END 0x800000UL       /* Adresser fr RAM brjar hr i AVR-ELF-filer. */
+#define SPEC_SIZE 32               /* Maximal lngd p en konvertering. */
+
+/* Statiska variabler: */
+static uint8_t* elf = 0;                /* ELF-filens innehll. */
+static size_t elf_size = 0;             /* ELF-filens storlek i byte. */
+static unsigned long dropped = 0;       /* Antal frlorade meddelanden enligt mikrodatorn. */
+static unsigned long unknown_ids = 0;   /* Antal meddelanden med oknt id. */
+
+/********************************************************************************
+* load_elf: Lser in angiven ELF-fil. Returnerar true ifall filen r en
+*           32-bitars ELF-fil.
+*
+*           - path: Skvg till ELF-filen.
+********************************************************************************/
+static bool load_elf(const char* path)
+{
+   FILE* file = fopen(path, "rb");
+   long size;
+
+   if (!file || fseek(file, 0, SEEK_END) || (size = ftell(file)) < 0)
+   {
+      perror(path);
+      if (file) fclose(file);
+      return false;
+   }
+
+   rewind(file);
+   elf = malloc((size_t)size + 1);
+   elf_size = (size_t)size;
+
+   if (!elf || fread(elf, 1, elf_size, file) != elf_size)
+   {
+      perror(path);
+      fclose(file);
+      return false;
+   }
+
+   fclose(file);
+   elf[elf_size] = '\0';
+
+   if (elf_size < sizeof(Elf32_Ehdr) || memcmp(elf, ELFMAG, SELFMAG) || elf[EI_CLASS] != ELFCLASS32)
+   {
+      fprintf(stderr, "%s: not a 32-bit ELF file\n", path);
+      return false;
+   }
+   return true;
+}
+
+/********************************************************************************
+* find_format: Returnerar formatstrngen p angiven adress i programminnet,
+*              eller 0 ifall adressen inte finns i ngon laddad sektion.
+*
+*              - id: Formatstrngens adress i programminnet.
+********************************************************************************/
+static const char* find_format(const uint16_t id)
+{
+   const Elf32_Ehdr* header = (const Elf32_Ehdr*)elf;
+
+   for (uint16_t i = 0; i < header->e_shnum; ++i)
+   {
+      const size_t offset = header->e_shoff + (size_t)i * header->e_shentsize;
+      if (offset + sizeof(Elf32_Shdr) > elf_size) break;
+      const Elf32_Shdr* section = (const Elf32_Shdr*)(elf + offset);
+
+      if (section->sh_type != SHT_PROGBITS || !(section->sh_flags & SHF_ALLOC)) continue;
+      if (section->sh_addr >= FLASH_END) continue;
+
+      if (id >= section->sh_addr && id < section->sh_addr + section->sh_size &&
+          section->sh_offset + section->sh_size <= elf_size)
+      {
+         return (const char*)(elf + section->sh_offset + (id - section->sh_addr));
+      }
+   }
+   return 0;
+}
+
+/********************************************************************************
+* print_message: Formaterar och skriver ut ett meddelande med angiven
+*                formatstrng och argument. Varje konvertering tolkas fr
+*                sig, dr argumentets storlek bestms av konverteringen p
+*                samma stt som p mikrodatorn (se log.h).
+*
+*                - format: Formatstrngen.
+*                - args  : Pekare till argumentens ra byte.
+*                - size  : Antal byte argument.
+********************************************************************************/
+static void print_message(const char* format,
+                          const uint8_t* args,
+                          size_t size)
+{
+   for (const char* i = format; *i; ++i)
+   {
+      char spec[SPEC_SIZE];
+      size_t n = 0;
+      bool is_long = false;
+
+      if (*i != '%')
+      {
+         putchar(*i);
+         continue;
+      }
+
+      if (i[1] == '%')
+      {
+         putchar('%');
+         i++;
+         continue;
+      }
+
+      spec[n++] = *i++;
+
+      while (*i && strchr("-+ #0123456789.hl", *i) && n < SPEC_SIZE - 2)
+      {
+         if (*i == 'l') is_long = true;
+         spec[n++] = *i++;
+      }
+
+      if (!*i) break;
+      spec[n++] = *i;
+      spec[n] = '\0';
+
+      const size_t arg_size = is_long || strchr("feEgG", *i) ? 4 : 2;
+
+      if (!strchr("diuxXocfeEgG", *i))
+      {
+         printf("<unsupported %s>", spec);
+         continue;
+      }
+
+      if (arg_size > size)
+      {
+         printf("<missing>");
+         continue;
+      }
+
+      const uint32_t raw = frame_read_le(args, arg_size);
+      args += arg_size;
+      size -= arg_size;
+
+      if (strchr("feEgG", *i))
+      {
+         float value;
+         memcpy(&value, &raw, sizeof(value));
+         printf(spec, (double)value);
+      }
+      else if (is_long)
+      {
+         if (strchr("di", *i)) printf(spec, (long)(int32_t)raw);
+         else printf(spec, (unsigned long)raw);
+      }
+      else
+      {
+         if (strchr("dic", *i)) printf(spec, (int)(int16_t)raw);
+         else printf(spec, (unsigned)(uint16_t)raw);
+      }
+   }
+
+   putchar('\n');
+   return;
+}
+
+/********************************************************************************
+* handle_frame: Slr upp formatstrngen fr en loggram och skriver ut
+*               meddelandet. Meddelanden med oknt id skrivs ut med id:t.
+*
+*               - type  : Ramens typbyte.
+*               - frame : Pekare till ramens data.
+*               - length: Antal byte data.
+********************************************************************************/
+static void handle_frame(const uint8_t type,
+                         const uint8_t* frame,
+                         const size_t length)
+{
+   if (type != FRAME_TYPE_LOG || length < HEADER_SIZE) return;
+
+   const uint16_t id = (uint16_t)frame_read_le(frame + 1, 2);
+   const char* format = find_format(id);
+
+   if (frame[0])
+   {
+      dropped += frame[0];
+      fprintf(stderr, "%u log messages dropped\n", frame[0]);
+   }
+
+   if (!format)
+   {
+      unknown_ids++;
+      printf("<unknown id 0x%04X>\n", id);
+      return;
+   }
+
+   print_message(format, frame + HEADER_SIZE, length - HEADER_SIZE);
+   return;
+}
+
+/********************************************************************************
+* main: Lser in ELF-filen, varefter ramar lses och avkodas tills strmmen
+*       tar slut. Sammanfattning skrivs ut till standard error vid slut.
+********************************************************************************/
+int main(int argc, char** argv)
+{
+   struct frame_stats stats = { 0, 0 };
+
+   if (argc < 2)
+   {
+      fprintf(stderr, "usage: %s <elf file> [device] [baud rate]\n", argv[0]);
+      return 1;
+   }
+
+   if (!load_elf(argv[1])) return 1;
+
+   const int fd = frame_open(argc >= 3 ? argv[2] : 0, argc >= 4 ? atol(argv[3]) : 9600);
+   if (fd < 0) return 1;
+   frame_read(fd, handle_frame, &stats);
+
+   fprintf(stderr, "frames: %lu, bad: %lu, dropped: %lu, unknown ids: %lu\n",
+           stats.frames, stats.bad_frames, dropped, unknown_ids);
+   free(elf);
+   return 0;
+}
\ No newline at end of file
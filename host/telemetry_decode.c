@@ -0,0 +1,116 @@
+/********************************************************************************
+* telemetry_decode.c: Avkodare fr binr telemetri (se telemetry.h), avsedd
+*                     att kras p en Linux-dator. Ramar lses antingen frn
+*                     standard input eller direkt frn en seriell port och
+*                     avkodas via frame_decode.h. Samtliga poster i ramar av
+*                     typen FRAME_TYPE_TELEMETRY skrivs ut en per rad:
+*
+*                     <tid i us> <kanal> <vrde>
+*
+*                     Avbrutna sekvensnummer samt felaktiga ramar rknas och
+*                     skrivs ut till standard error. Ramar av andra typer
+*                     (exempelvis loggmeddelanden) ignoreras.
+*
+*                     Kompilering samt exempel p anvndning:
+*
+*                     gcc -O2 -o telemetry_decode telemetry_decode.c
+*                     ./telemetry_decode /dev/ttyACM0 9600
+*                     ./telemetry_decode < capture.bin
+********************************************************************************/
+#include "frame_decode.h"
+
+/* Makrodefinitioner: */
+#define FRAME_TYPE_TELEMETRY 'T' /* Typbyte fr telemetriramar. */
+#define HEADER_SIZE 5            /* Sekvensnummer (1) samt bastid (4). */
+
+/* Statiska variabler: */
+static unsigned long lost_frames = 0;   /* Antal frlorade ramar enligt sekvensnummer. */
+static bool sequence_valid = false;     /* Indikerar ifall fregende sekvensnummer r knt. */
+static uint8_t expected_sequence = 0;   /* Frvntat sekvensnummer fr nsta ram. */
+
+/********************************************************************************
+* print_frame: Skriver ut samtliga poster i en telemetriram. Ramen avbryts
+*              ifall en post inte ryms i ramen.
+*
+*              - type  : Ramens typbyte.
+*              - frame : Pekare till ramens data.
+*              - length: Antal byte data.
+********************************************************************************/
+static void print_frame(const uint8_t type,
+                        const uint8_t* frame,
+                        const size_t length)
+{
+   size_t i = HEADER_SIZE;
+
+   if (type != FRAME_TYPE_TELEMETRY || length < HEADER_SIZE) return;
+
+   const uint8_t sequence = frame[0];
+   const uint32_t base_us = frame_read_le(frame + 1, 4);
+
+   if (sequence_valid && sequence != expected_sequence)
+   {
+      const uint8_t lost = (uint8_t)(sequence - expected_sequence);
+      lost_frames += lost;
+      fprintf(stderr, "sequence gap: expected %u, got %u (%u lost)\n",
+              expected_sequence, sequence, lost);
+   }
+
+   sequence_valid = true;
+   expected_sequence = (uint8_t)(sequence + 1);
+
+   while (i < length)
+   {
+      const uint8_t record_type = frame[i] >> 6;
+      const uint8_t channel = frame[i] & 0x3F;
+      const size_t size = record_type < 2 ? 2 : 4;
+
+      if (i + 3 + size > length)
+      {
+         fprintf(stderr, "truncated record in frame %u\n", sequence);
+         return;
+      }
+
+      const uint32_t time_us = base_us + frame_read_le(frame + i + 1, 2);
+      const uint32_t raw = frame_read_le(frame + i + 3, size);
+      i += 3 + size;
+
+      printf("%lu %u ", (unsigned long)time_us, channel);
+
+      if (record_type == 0)
+      {
+         printf("%d\n", (int16_t)raw);
+      }
+      else if (record_type == 1)
+      {
+         printf("%u\n", (uint16_t)raw);
+      }
+      else if (record_type == 2)
+      {
+         printf("%ld\n", (long)(int32_t)raw);
+      }
+      else
+      {
+         float value;
+         memcpy(&value, &raw, sizeof(value));
+         printf("%g\n", value);
+      }
+   }
+   return;
+}
+
+/********************************************************************************
+* main: Lser och avkodar ramar tills strmmen tar slut. Sammanfattning
+*       skrivs ut till standard error vid slut.
+********************************************************************************/
+int main(int argc, char** argv)
+{
+   struct frame_stats stats = { 0, 0 };
+   const int fd = frame_open(argc >= 2 ? argv[1] : 0, argc >= 3 ? atol(argv[2]) : 9600);
+
+   if (fd < 0) return 1;
+   frame_read(fd, print_frame, &stats);
+
+   fprintf(stderr, "frames: %lu, bad: %lu, lost: %lu\n",
+           stats.frames, stats.bad_frames, lost_frames);
+   return 0;
+}
\ No newline at end of file
@@ -0,0 +1,240 @@
+/********************************************************************************
+* icp.c: Innehåller funktionsdefinitioner samt avbrottsrutin för mätning av
+*        externa signaler via input capture på Timer 1.
+********************************************************************************/
+#include "icp.h"
+#include "isr_probe.h"
+
+/* Makrodefinitioner: */
+#define ICP_BUFFER_MASK (ICP_BUFFER_SIZE - 1) /* Bitmask för index i ringbufferten. */
+#define ICP_PIN 0                             /* ICP1 är ansluten till pin 8 (PORTB0). */
+
+/* Statiska variabler: */
+static volatile struct icp_capture buffer[ICP_BUFFER_SIZE]; /* Ringbuffert för fångade flanker. */
+static volatile uint8_t head = 0;         /* Index där nästa flank lagras. */
+static volatile uint8_t tail = 0;         /* Index för äldsta olästa flank. */
+static volatile uint16_t overruns = 0;    /* Antal förlorade flanker. */
+static volatile uint32_t last_edge[2];    /* Senaste tidpunkt per flank (fallande, stigande). */
+static volatile bool last_valid[2];       /* Indikerar ifall respektive tidpunkt är giltig. */
+static volatile uint32_t period = 0;      /* Senast uppmätta periodtid i klockcykler. */
+static volatile uint32_t high_time = 0;   /* Senast uppmätta tid hög i klockcykler. */
+static enum icp_edge edge_sel = ICP_EDGE_RISING; /* Flanken som ska fångas. */
+
+/* Statiska funktioner: */
+static inline uint32_t icp_read_atomic(const volatile uint32_t* value);
+
+/********************************************************************************
+* icp_init: Initierar input capture på pin 8 (PORTB0/ICP1). Pinnen sätts till
+*           inport utan pullup-motstånd, vald flank samt brusfilter ställs in
+*           i TCCR1B och capture-avbrott aktiveras. Timerns klocka samt mode
+*           lämnas orörda, då dessa ägs av tidsbasen i sysclock. Avbrott
+*           inaktiveras tillfälligt och återställs sedan till sitt tidigare
+*           tillstånd, precis som i icp_disable.
+*
+*           - edge          : Flanken som ska fångas.
+*           - noise_canceler: Indikerar ifall brusfiltret ska aktiveras.
+********************************************************************************/
+void icp_init(const enum icp_edge edge,
+              const bool noise_canceler)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   DDRB &= ~(1 << ICP_PIN);
+   PORTB &= ~(1 << ICP_PIN);
+
+   head = 0;
+   tail = 0;
+   overruns = 0;
+   period = 0;
+   high_time = 0;
+   last_valid[0] = false;
+   last_valid[1] = false;
+   edge_sel = edge;
+
+   if (edge == ICP_EDGE_FALLING)
+   {
+      TCCR1B &= ~(1 << ICES1);
+   }
+   else
+   {
+      TCCR1B |= (1 << ICES1);
+   }
+
+   if (noise_canceler)
+   {
+      TCCR1B |= (1 << ICNC1);
+   }
+   else
+   {
+      TCCR1B &= ~(1 << ICNC1);
+   }
+
+   TIFR1 = (1 << ICF1);
+   TIMSK1 |= (1 << ICIE1);
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* icp_disable: Inaktiverar input capture genom att capture-avbrott inaktiveras.
+********************************************************************************/
+void icp_disable(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   TIMSK1 &= ~(1 << ICIE1);
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* icp_available: Returnerar antalet fångade flanker som ligger i ringbufferten.
+*                Indexen är 8 bitar och läses därmed alltid i en instruktion.
+********************************************************************************/
+uint8_t icp_available(void)
+{
+   return (uint8_t)(head - tail) & ICP_BUFFER_MASK;
+}
+
+/********************************************************************************
+* icp_read: Läser ut den äldsta fångade flanken ur ringbufferten. Endast
+*           huvudprogrammet skriver till tail och endast avbrottsrutinen
+*           skriver till head, varför avbrott inte behöver inaktiveras.
+*
+*           - capture: Pekare till strukt där den fångade flanken lagras.
+********************************************************************************/
+bool icp_read(struct icp_capture* capture)
+{
+   const uint8_t index = tail;
+
+   if (index == head) return false;
+
+   capture->timestamp = buffer[index].timestamp;
+   capture->rising = buffer[index].rising;
+   tail = (index + 1) & ICP_BUFFER_MASK;
+   return true;
+}
+
+/********************************************************************************
+* icp_overruns: Returnerar antalet flanker som har förlorats på grund av att
+*               ringbufferten var full.
+********************************************************************************/
+uint16_t icp_overruns(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint16_t num_overruns = overruns;
+   SREG = sreg;
+   return num_overruns;
+}
+
+/********************************************************************************
+* icp_period_cycles: Returnerar senast uppmätta periodtid mätt i klockcykler.
+********************************************************************************/
+uint32_t icp_period_cycles(void)
+{
+   return icp_read_atomic(&period);
+}
+
+/********************************************************************************
+* icp_high_cycles: Returnerar senast uppmätta tid som signalen var hög mätt i
+*                  klockcykler.
+********************************************************************************/
+uint32_t icp_high_cycles(void)
+{
+   return icp_read_atomic(&high_time);
+}
+
+/********************************************************************************
+* icp_frequency_hz: Returnerar frekvensen för senast uppmätta period mätt i Hz.
+*                   Ifall ingen period har uppmätts returneras 0.
+********************************************************************************/
+double icp_frequency_hz(void)
+{
+   const uint32_t cycles = icp_period_cycles();
+   if (!cycles) return 0;
+   return (double)F_CPU / cycles;
+}
+
+/********************************************************************************
+* icp_duty_cycle: Returnerar duty cycle för senast uppmätta period som ett
+*                 flyttal mellan 0 - 1. Periodtid samt tid hög läses av
+*                 tillsammans, så att båda härrör från samma period.
+********************************************************************************/
+double icp_duty_cycle(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint32_t cycles = period;
+   const uint32_t high = high_time;
+   SREG = sreg;
+
+   if (!cycles || high > cycles) return 0;
+   return (double)high / cycles;
+}
+
+/********************************************************************************
+* ISR (TIMER1_CAPT_vect): Avbrottsrutin som äger rum vid fångad flank på ICP1.
+*                         Fångat räknarvärde utökas till 32 bitar via
+*                         tidsbasen och lagras i ringbufferten. Periodtiden
+*                         beräknas som tiden sedan föregående flank av samma
+*                         slag, medan tiden hög beräknas vid fallande flank.
+*                         Vid fångst av båda flankerna växlas vald flank,
+*                         varefter capture-flaggan nollställs enligt databladet.
+********************************************************************************/
+ISR (TIMER1_CAPT_vect)
+{
+   ISR_PROBE_ENTER(TCNT1 - ICR1);
+   const uint16_t count = ICR1;
+   const bool rising = TCCR1B & (1 << ICES1);
+   const uint32_t timestamp = sysclock_extend(count);
+
+   if (edge_sel == ICP_EDGE_BOTH)
+   {
+      TCCR1B ^= (1 << ICES1);
+      TIFR1 = (1 << ICF1);
+   }
+
+   if (last_valid[rising])
+   {
+      period = timestamp - last_edge[rising];
+   }
+
+   if (!rising && last_valid[1])
+   {
+      high_time = timestamp - last_edge[1];
+   }
+
+   last_edge[rising] = timestamp;
+   last_valid[rising] = true;
+
+   const uint8_t next = (head + 1) & ICP_BUFFER_MASK;
+
+   if (next == tail)
+   {
+      overruns++;
+   }
+   else
+   {
+      buffer[head].timestamp = timestamp;
+      buffer[head].rising = rising;
+      head = next;
+   }
+   ISR_PROBE_EXIT(ISR_PROBE_TIMER1_CAPT);
+   return;
+}
+
+/********************************************************************************
+* icp_read_atomic: Läser av en 32-bitars variabel som uppdateras i
+*                  avbrottsrutinen med avbrott tillfälligt inaktiverade.
+*
+*                  - value: Pekare till variabeln som ska läsas av.
+********************************************************************************/
+static inline uint32_t icp_read_atomic(const volatile uint32_t* value)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint32_t result = *value;
+   SREG = sreg;
+   return result;
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+/********************************************************************************
+* icp.h: Innehåller drivrutiner för mätning av externa signaler via enheten
+*        för input capture på Timer 1, ansluten till pin 8 (PORTB0/ICP1).
+*
+*        Vid en flank på ICP1 fångar hårdvaran Timer 1:s räknarvärde i ICR1,
+*        varefter avbrottsvektorn TIMER1_CAPT_vect anropas. Timer 1 löper
+*        fritt som systemets tidsbas (se sysclock.h), vilket ger en
+*        upplösning på 0,5 us med prescaler 8 (62,5 ns med prescaler 1,
+*        se SYSCLOCK_PRESCALER). Det fångade värdet utökas till 32 bitar
+*        via tidsbasens overflow-räknare, så att perioder upp till cirka
+*        268 sekunder kan mätas. Tider anges i klockcykler (1 / 16 us),
+*        men är alltid en multipel av SYSCLOCK_PRESCALER, varför 16 MHz
+*        upplösning endast erhålls med prescaler 1, exempelvis i
+*        instrumenterade byggen (se isr_probe.h). Varje flank lagras med
+*        tidsstämpel i en ringbuffert, som töms från huvudprogrammet. Ingen
+*        pollning krävs.
+*
+*        Periodtid, frekvens samt duty cycle beräknas från de senast fångade
+*        flankerna. För duty cycle krävs att båda flankerna fångas, där
+*        flanken som detekteras växlas i avbrottsrutinen.
+*
+*        Observera att pin 8 även används av lysdioden l1 i header.h, varför
+*        drivrutinen inte används i aktuellt program. Vid simulering i simavr
+*        kan en extern signal kopplas till pinnen via ett IRQ på PORTB0.
+*
+*        Exempel på användning:
+*
+*        int main(void)
+*        {
+*           sysclock_init();
+*           icp_init(ICP_EDGE_BOTH, true);
+*
+*           while (1)
+*           {
+*              const double frequency = icp_frequency_hz();
+*              const double duty_cycle = icp_duty_cycle();
+*           }
+*        }
+********************************************************************************/
+#ifndef ICP_H_
+#define ICP_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+#include "sysclock.h"
+
+/* Makrodefinitioner: */
+#define ICP_BUFFER_SIZE 16 /* Antal platser i ringbufferten (måste vara en tvåpotens). */
+
+/********************************************************************************
+* icp_edge: Enumeration för val av flank som ska fångas.
+********************************************************************************/
+enum icp_edge
+{
+   ICP_EDGE_FALLING, /* Fallande flank. */
+   ICP_EDGE_RISING,  /* Stigande flank. */
+   ICP_EDGE_BOTH     /* Både stigande och fallande flank. */
+};
+
+/********************************************************************************
+* icp_capture: Strukt för lagring av en fångad flank.
+********************************************************************************/
+struct icp_capture
+{
+   uint32_t timestamp; /* Tidpunkt mätt i klockcykler, se sysclock_cycles. */
+   bool rising;        /* Indikerar ifall flanken var stigande. */
+};
+
+/********************************************************************************
+* icp_init: Initierar input capture på pin 8 (PORTB0/ICP1). Tidsbasen i
+*           sysclock måste vara initierad, eftersom Timer 1 inte
+*           konfigureras om. Tidigare fångade flanker samt mätvärden nollställs.
+*
+*           - edge          : Flanken som ska fångas.
+*           - noise_canceler: Indikerar ifall brusfiltret ska aktiveras, vilket
+*                             fördröjer varje fångst med fyra klockcykler.
+********************************************************************************/
+void icp_init(const enum icp_edge edge,
+              const bool noise_canceler);
+
+/********************************************************************************
+* icp_disable: Inaktiverar input capture. Fångade flanker ligger kvar.
+********************************************************************************/
+void icp_disable(void);
+
+/********************************************************************************
+* icp_available: Returnerar antalet fångade flanker som ligger i ringbufferten.
+********************************************************************************/
+uint8_t icp_available(void);
+
+/********************************************************************************
+* icp_read: Läser ut den äldsta fångade flanken ur ringbufferten. Ifall
+*           bufferten är tom returneras false, annars returneras true.
+*
+*           - capture: Pekare till strukt där den fångade flanken lagras.
+********************************************************************************/
+bool icp_read(struct icp_capture* capture);
+
+/********************************************************************************
+* icp_overruns: Returnerar antalet flanker som har förlorats på grund av att
+*               ringbufferten var full.
+********************************************************************************/
+uint16_t icp_overruns(void);
+
+/********************************************************************************
+* icp_period_cycles: Returnerar senast uppmätta periodtid mätt i klockcykler,
+*                    alltså tiden mellan de två senaste flankerna av samma
+*                    slag. Ifall ingen period har uppmätts returneras 0.
+********************************************************************************/
+uint32_t icp_period_cycles(void);
+
+/********************************************************************************
+* icp_high_cycles: Returnerar senast uppmätta tid som signalen var hög mätt i
+*                  klockcykler. Kräver att båda flankerna fångas. Ifall
+*                  ingen sådan tid har uppmätts returneras 0.
+********************************************************************************/
+uint32_t icp_high_cycles(void);
+
+/********************************************************************************
+* icp_period_us: Returnerar senast uppmätta periodtid mätt i mikrosekunder.
+********************************************************************************/
+static inline double icp_period_us(void)
+{
+   return icp_period_cycles() / (F_CPU / 1000000.0);
+}
+
+/********************************************************************************
+* icp_frequency_hz: Returnerar frekvensen för senast uppmätta period mätt i Hz.
+*                   Ifall ingen period har uppmätts returneras 0.
+********************************************************************************/
+double icp_frequency_hz(void);
+
+/********************************************************************************
+* icp_duty_cycle: Returnerar duty cycle för senast uppmätta period som ett
+*                 flyttal mellan 0 - 1. Kräver att båda flankerna fångas.
+*                 Ifall ingen period har uppmätts returneras 0.
+********************************************************************************/
+double icp_duty_cycle(void);
+
+#endif /* ICP_H_ */
\ No newline at end of file
@@ -1,109 +1,74 @@
-/********************************************************************************
-* isr.c: Innehller avbrottsrutiner.
-********************************************************************************/
-#include "header.h"
-
-/********************************************************************************
-* ISR (PCINT0_vect): Avbrottsrutin som ger rum vid nedtryckning/uppslppning
-*                    av tryckknapp b1 ansluten till pin 13 (PORTB5).
-*                    Vid nedtryckning terstlls Watchdog-timern, vilket
-*                    skrivs ut i ansluten seriell terminal. Dremot vid
-*                    uppslppning grs ingenting.
-*
-*                    Oavsett vad som orsakade avbrottet inaktiveras PCI-avbrott
-*                    p I/O-port B i 300 millisekunder via timer 0 fr att
-*                    undvika multipla avbrott orsakade av kontaktstudsar.
-********************************************************************************/
+/********************************************************************************
+* isr.c: Innehåller avbrottsrutiner.
+********************************************************************************/
+#include "header.h"
+#include "isr_probe.h"
+
+/********************************************************************************
+* ISR (PCINT0_vect): Avbrottsrutin som äger rum vid nedtryckning/uppsläppning
+*                    av tryckknapp b1 ansluten till pin 13 (PORTB5).
+*                    Vid nedtryckning återställs Watchdog-timern, vilket
+*                    postas som en händelse för utskrift i ansluten seriell
+*                    terminal från huvudloopen. Däremot vid uppsläppning
+*                    görs ingenting.
+*
+*                    Oavsett vad som orsakade avbrottet inaktiveras PCI-avbrott
+*                    på I/O-port B i 300 millisekunder via mjukvarutimern t0
+*                    för att undvika multipla avbrott orsakade av
+*                    kontaktstudsar. Eftersom mjukvarutimers endast får
+*                    startas från huvudloopen signaleras en task, som i sin
+*                    tur startar timern.
+********************************************************************************/
 ISR (PCINT0_vect)
 {
+   ISR_PROBE_ENTER(ISR_PROBE_NO_LATENCY);
    disable_pin_change_interrupt(IO_PORTB);
-   timer_enable_interrupt(&t0);
+   task_signal(&debounce_task);
 
    if (button_is_pressed(&b1))
    {
       wdt_reset();
-      serial_print_string("Watchdog timer reset!\n");
-   }
-
-   return;
-}
-
-/********************************************************************************
-* ISR (TIMER0_OVF_vect): Avbrottsrutin som ger rum vid overflow av Timer 0,
-*                        dvs. upprkning till 256, vilket sker var 0.128:e
-*                        millisekund nr timern r aktiverad.
-*
-*                        Timern rknas upp via upprkning av varje passerat
-*                        avbrott. Nr timern lper ut (nr berknat antal
-*                        avbrott fr specificerad tid har rknats upp) s
-*                        teraktiveras PCI-avbrott p I/O-port B (som har
-*                        stngts av i 300 millisekunder fr att undvika
-*                        multipla avbrott orsakat av kontaktstudsar), fljt
-*                        av att timern stngs av.
-********************************************************************************/
-ISR (TIMER0_OVF_vect)
-{
-   timer_count(&t0);
-
-   if (timer_elapsed(&t0))
-   {
-      enable_pin_change_interrupt(IO_PORTB);
-      timer_disable_interrupt(&t0);
+      event_post(APP_EVENT_WDT_RESET, 0);
+      LOG_DEBUG(WDT, "reset by button");
    }
 
+   ISR_PROBE_EXIT(ISR_PROBE_PCINT0);
    return;
 }
 
-/********************************************************************************
-* ISR (TIMER1_COMPA_vect): Avbrottsrutin som ger rum vid upprkning till 256 av
-*                          Timer 1 i CTC Mode, vilket sker var 0.128:e
-*                          millisekund nr timern r aktiverad.
-*
-*                          Timern rknas upp via upprkning av varje passerat
-*                          avbrott. Nr timern lper ut (var 50:e millisekund
-*                          nr timern r aktiverad) togglas lysdiod l1.
-********************************************************************************/
-ISR (TIMER1_COMPA_vect)
-{
-   timer_count(&t1);
-
-   if (timer_elapsed(&t1))
-   {
-      led_toggle(&l1);
-   }
-
-   return;
-}
-
-/********************************************************************************
-* ISR (WDT_vect): Avbrottsrutin som ger rum vid Watchdog timeout, vilket sker
-*                 om Watchdog-timern inte blir terslld var 8192:e millisekund.
-*                 Antalet timeouts rknas upp och skrivs ut i ansluten seriell
-*                 terminal. Nr maximalt antal timeouts har genomfrts lses
-*                 systemet i ett tillstnd dr lysdioden ansluten till pin 8
-*                 (PORTB0) blinkar var 50:e millisekund.
+/********************************************************************************
+* ISR (WDT_vect): Avbrottsrutin som äger rum vid Watchdog timeout, vilket sker
+*                 om Watchdog-timern inte blir återsälld var 8192:e millisekund.
+*                 Antalet timeouts räknas upp och postas som en händelse för
+*                 utskrift i ansluten seriell terminal från huvudloopen, så
+*                 att avbrottsrutinen inte blockerar under utskriften.
+*                 Timeouten loggas även binärt (se log.h). När
+*                 maximalt antal timeouts har genomförts låses systemet i ett
+*                 tillstånd där lysdioden ansluten till pin 8 (PORTB0)
+*                 blinkar var 50:e millisekund via mjukvarutimern t1, som
+*                 startas från en task som signaleras här.
 ********************************************************************************/
 ISR (WDT_vect)
-{
+{
    static volatile uint8_t num_timeouts = 0;
+   ISR_PROBE_ENTER(ISR_PROBE_NO_LATENCY);
 
-   serial_print_string("Number of timeouts: ");
-   serial_print_unsigned(++num_timeouts);
-   serial_print_new_line();
+   event_post(APP_EVENT_WDT_TIMEOUT, ++num_timeouts);
+   LOG_WARN(WDT, "timeout %u of %u", num_timeouts, TIMEOUT_MAX);
 
    if (num_timeouts >= TIMEOUT_MAX)
    {
-      serial_print_string("Maximum number of timeouts has elapsed!\n");
-      serial_print_string("System lockdown!\n");
+      event_post(APP_EVENT_LOCKDOWN, 0);
+      LOG_ERROR(WDT, "system lockdown after %u timeouts", num_timeouts);
 
       button_clear(&b1);
-      timer_clear(&t0);
-      timer_enable_interrupt(&t1);
+      task_signal(&lockdown_task);
       wdt_clear();    
    }
    else
    {
       wdt_enable_interrupt();
    }
+   ISR_PROBE_EXIT(ISR_PROBE_WDT);
    return;
 }
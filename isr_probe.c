@@ -0,0 +1,148 @@
+/********************************************************************************
+* isr_probe.c: Innehåller funktionsdefinitioner för instrumentering av
+*              avbrottsrutiner. Filen kompileras till ingenting ifall
+*              instrumenteringen är avstängd, där endast en typdeklaration
+*              finns kvar eftersom ISO C inte tillåter en tom
+*              översättningsenhet (varning vid -Wpedantic).
+********************************************************************************/
+#include "isr_probe.h"
+
+#if ISR_PROBE_ENABLED
+
+#include "serial.h"
+
+/* Statiska variabler: */
+static volatile struct isr_probe_stats stats[ISR_PROBE_COUNT]; /* Statistik per avbrottsrutin. */
+
+/* Namn på instrumenterade avbrottsrutiner, indexerade via isr_probe_id (lagras i programminnet): */
+static const char names[ISR_PROBE_COUNT][13] PROGMEM =
+{
+   "PCINT0",
+   "TIMER1_OVF",
+   "TIMER1_COMPA",
+   "WDT",
+   "SOFT_TICK",
+   "TIMER1_CAPT",
+   "ADC",
+   "USART_RX",
+   "USART_UDRE",
+   "SOFT_RUN",
+   "SOFT_NEXT"
+};
+
+/********************************************************************************
+* isr_probe_record: Registrerar en mätning för angiven avbrottsrutin. Avbrott
+*                   inaktiveras under uppdateringen och tidigare
+*                   avbrottsstatus återställs efteråt, så att funktionen även
+*                   kan anropas från huvudloopen.
+*
+*                   - id      : Id för avbrottsrutinen.
+*                   - duration: Exekveringstiden i räknarsteg.
+*                   - latency : Latensen i räknarsteg.
+********************************************************************************/
+void isr_probe_record(const enum isr_probe_id id,
+                      const uint16_t duration,
+                      const uint16_t latency)
+{
+   volatile struct isr_probe_stats* self = &stats[id];
+   const uint8_t sreg = SREG;
+   asm("CLI");
+
+   if (self->count++ == 0)
+   {
+      self->duration_min = duration;
+      self->duration_max = duration;
+      self->duration_avg = duration;
+   }
+   else
+   {
+      if (duration < self->duration_min) self->duration_min = duration;
+      if (duration > self->duration_max) self->duration_max = duration;
+      self->duration_avg += ((int16_t)(duration - self->duration_avg)) / 16;
+   }
+
+   if (latency != ISR_PROBE_NO_LATENCY)
+   {
+      if (!self->latency_valid || latency > self->latency_max)
+      {
+         self->latency_max = latency;
+      }
+      self->latency_valid = true;
+   }
+
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* isr_probe_reset: Nollställer statistiken för samtliga avbrottsrutiner.
+********************************************************************************/
+void isr_probe_reset(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+
+   for (uint8_t i = 0; i < ISR_PROBE_COUNT; ++i)
+   {
+      stats[i].count = 0;
+      stats[i].duration_min = 0;
+      stats[i].duration_max = 0;
+      stats[i].duration_avg = 0;
+      stats[i].latency_max = 0;
+      stats[i].latency_valid = false;
+   }
+
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* isr_probe_print: Skriver ut statistiken för samtliga avbrottsrutiner som har
+*                  exekverat. Statistiken för varje rutin kopieras med avbrott
+*                  inaktiverade, så att utskriften inte blandar gamla och nya
+*                  värden. Själva utskriften sker med avbrott aktiverade,
+*                  där räknarsteg omvandlas till klockcykler.
+********************************************************************************/
+void isr_probe_print(void)
+{
+   for (uint8_t i = 0; i < ISR_PROBE_COUNT; ++i)
+   {
+      struct isr_probe_stats copy;
+      const uint8_t sreg = SREG;
+      asm("CLI");
+      copy.count = stats[i].count;
+      copy.duration_min = stats[i].duration_min;
+      copy.duration_max = stats[i].duration_max;
+      copy.duration_avg = stats[i].duration_avg;
+      copy.latency_max = stats[i].latency_max;
+      copy.latency_valid = stats[i].latency_valid;
+      SREG = sreg;
+
+      if (!copy.count) continue;
+
+      serial_print_string_P(names[i]);
+      SERIAL_PRINT_P(": count ");
+      serial_print_unsigned(copy.count);
+      SERIAL_PRINT_P(", min ");
+      serial_print_unsigned((uint32_t)copy.duration_min * SYSCLOCK_PRESCALER);
+      SERIAL_PRINT_P(", avg ");
+      serial_print_unsigned((uint32_t)copy.duration_avg * SYSCLOCK_PRESCALER);
+      SERIAL_PRINT_P(", max ");
+      serial_print_unsigned((uint32_t)copy.duration_max * SYSCLOCK_PRESCALER);
+
+      if (copy.latency_valid)
+      {
+         SERIAL_PRINT_P(", max latency ");
+         serial_print_unsigned((uint32_t)copy.latency_max * SYSCLOCK_PRESCALER);
+      }
+
+      SERIAL_PRINT_P(" cycles\n");
+   }
+   return;
+}
+
+#else
+
+typedef int isr_probe_disabled; /* Deklaration så att översättningsenheten inte blir tom. */
+
+#endif /* ISR_PROBE_ENABLED */
\ No newline at end of file
@@ -0,0 +1,145 @@
+/********************************************************************************
+* isr_probe.h: Innehåller instrumentering för mätning av exekveringstid samt
+*              latens för avbrottsrutiner. Instrumenteringen är avstängd som
+*              default och aktiveras genom att definiera ISR_PROBE_ENABLED
+*              till 1, exempelvis via kompilatorflaggan -DISR_PROBE_ENABLED=1.
+*              När instrumenteringen är avstängd expanderas samtliga makron
+*              till ingenting och funktionerna till tomma inline-funktioner,
+*              vilket gör att varken programminne, RAM eller klockcykler tas
+*              i anspråk.
+*
+*              Tidsstämplar läses från TCNT1, som löper fritt som systemets
+*              tidsbas (se sysclock.h). Exekveringstiden mäts från
+*              ISR_PROBE_ENTER till ISR_PROBE_EXIT i räknarsteg, exklusive
+*              avbrottsrutinens prolog samt epilog (cirka 20 - 40 klockcykler
+*              beroende på antalet register som sparas undan), och skrivs ut
+*              i klockcykler. För att tidsstämplarna ska ha upplösningen en
+*              klockcykel (16 MHz) körs tidsbasen med prescaler 1 när
+*              instrumenteringen är aktiverad, se sysclock.h. Att samtidigt
+*              ange någon annan prescaler ger kompileringsfel. Mätningar över
+*              65 535 klockcykler (ca 4 ms) slår runt.
+*
+*              Latensen, alltså tiden från att avbrottet utlöstes tills
+*              avbrottsrutinen startade, kan endast mätas exakt för avbrott
+*              som utlöses av Timer 1 (overflow, compare A samt input
+*              capture via ICR1). För övriga avbrott anges
+*              ISR_PROBE_NO_LATENCY, varvid ingen latens registreras.
+*
+*              Exempel på användning:
+*
+*              ISR (TIMER1_COMPA_vect)
+*              {
+*                 ISR_PROBE_ENTER(TCNT1 - OCR1A);
+*                 ...
+*                 ISR_PROBE_EXIT(ISR_PROBE_TIMER1_COMPA);
+*              }
+********************************************************************************/
+#ifndef ISR_PROBE_H_
+#define ISR_PROBE_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+#include "sysclock.h"
+
+/* Makrodefinitioner: */
+#ifndef ISR_PROBE_ENABLED
+#define ISR_PROBE_ENABLED 0 /* 1 för att aktivera instrumenteringen. */
+#endif
+
+#if ISR_PROBE_ENABLED && SYSCLOCK_PRESCALER != 1
+#error "ISR_PROBE_ENABLED requires SYSCLOCK_PRESCALER 1 (16 MHz timestamps)!"
+#endif
+
+#define ISR_PROBE_NO_LATENCY 0xFFFF /* Indikerar att latensen inte kan mätas. */
+
+/********************************************************************************
+* isr_probe_id: Enumeration för de avbrottsrutiner som instrumenteras.
+********************************************************************************/
+enum isr_probe_id
+{
+   ISR_PROBE_PCINT0,       /* Avbrottsrutin för PCI-avbrott på I/O-port B. */
+   ISR_PROBE_TIMER1_OVF,   /* Avbrottsrutin för overflow på Timer 1 (tidsbasen). */
+   ISR_PROBE_TIMER1_COMPA, /* Avbrottsrutin för compare-avbrott på Timer 1 (alarm). */
+   ISR_PROBE_WDT,          /* Avbrottsrutin för Watchdog timeout. */
+   ISR_PROBE_SOFT_TICK,    /* Tickhantering för timerhjulet, se soft_timer_tick. */
+   ISR_PROBE_TIMER1_CAPT,  /* Avbrottsrutin för input capture på Timer 1, se icp.h. */
+   ISR_PROBE_ADC,          /* Avbrottsrutin för färdig AD-omvandling, se adc.h. */
+   ISR_PROBE_USART_RX,     /* Avbrottsrutin för mottaget tecken, se serial.h. */
+   ISR_PROBE_USART_UDRE,   /* Avbrottsrutin för tomt dataregister vid sändning. */
+   ISR_PROBE_SOFT_RUN,     /* Hantering av utgångna timers i huvudloopen, se soft_timer_run. */
+   ISR_PROBE_SOFT_NEXT,    /* Sökning efter närmast utgående timer inför sleep. */
+   ISR_PROBE_COUNT         /* Antalet instrumenterade avbrottsrutiner. */
+};
+
+#if ISR_PROBE_ENABLED
+
+/********************************************************************************
+* isr_probe_stats: Strukt för lagring av statistik för en avbrottsrutin.
+********************************************************************************/
+struct isr_probe_stats
+{
+   uint32_t count;              /* Antal exekveringar av avbrottsrutinen. */
+   uint16_t duration_min;       /* Kortaste exekveringstid i räknarsteg. */
+   uint16_t duration_max;       /* Längsta exekveringstid i räknarsteg. */
+   uint16_t duration_avg;       /* Glidande medelvärde av exekveringstiden (1/16). */
+   uint16_t latency_max;        /* Längsta latens i räknarsteg. */
+   bool latency_valid;          /* Indikerar ifall latens har registrerats. */
+};
+
+/********************************************************************************
+* ISR_PROBE_ENTER: Lagrar tidsstämpel samt latens vid start av avbrottsrutin.
+*                  Makrot ska placeras först i avbrottsrutinen.
+*
+*                  - latency: Latensen i räknarsteg (ISR_PROBE_NO_LATENCY
+*                             ifall latensen inte kan mätas).
+********************************************************************************/
+#define ISR_PROBE_ENTER(latency) \
+   const uint16_t isr_probe_start = TCNT1; \
+   const uint16_t isr_probe_latency = (uint16_t)(latency)
+
+/********************************************************************************
+* ISR_PROBE_EXIT: Registrerar exekveringstid samt latens vid slutet av
+*                 avbrottsrutin. Makrot ska placeras sist i avbrottsrutinen.
+*
+*                 - id: Id för avbrottsrutinen, se enumerationen isr_probe_id.
+********************************************************************************/
+#define ISR_PROBE_EXIT(id) \
+   isr_probe_record(id, TCNT1 - isr_probe_start, isr_probe_latency)
+
+/********************************************************************************
+* isr_probe_record: Registrerar en mätning för angiven avbrottsrutin.
+*                   Funktionen anropas via makrot ISR_PROBE_EXIT, som även
+*                   kan användas kring kod i huvudloopen.
+*
+*                   - id      : Id för avbrottsrutinen.
+*                   - duration: Exekveringstiden i räknarsteg.
+*                   - latency : Latensen i räknarsteg.
+********************************************************************************/
+void isr_probe_record(const enum isr_probe_id id,
+                      const uint16_t duration,
+                      const uint16_t latency);
+
+/********************************************************************************
+* isr_probe_reset: Nollställer statistiken för samtliga avbrottsrutiner.
+********************************************************************************/
+void isr_probe_reset(void);
+
+/********************************************************************************
+* isr_probe_print: Skriver ut statistiken för samtliga avbrottsrutiner som
+*                  har exekverat via seriell överföring, en rad per rutin.
+*                  Tider skrivs ut i klockcykler (1 / 16 us), omräknat från
+*                  räknarsteg via SYSCLOCK_PRESCALER.
+********************************************************************************/
+void isr_probe_print(void);
+
+#else
+
+#define ISR_PROBE_ENTER(latency)
+#define ISR_PROBE_EXIT(id)
+
+static inline void isr_probe_reset(void) { }
+static inline void isr_probe_print(void) { }
+
+#endif /* ISR_PROBE_ENABLED */
+
+#endif /* ISR_PROBE_H_ */
\ No newline at end of file
@@ -0,0 +1,218 @@
+/********************************************************************************
+* log.c: Innehåller funktionsdefinitioner för fördröjd binär loggning.
+*
+*        Varje meddelande lagras i loggbufferten som en längdbyte följd av
+*        id samt argument, så att hela meddelanden kan hämtas ut i ett svep.
+********************************************************************************/
+#include "log.h"
+#include "frame.h"
+#include "serial.h"
+
+/* Makrodefinitioner: */
+#define LOG_BUFFER_MASK (LOG_BUFFER_SIZE - 1)              /* Bitmask för index i loggbufferten. */
+#define LOG_MESSAGE_SIZE_MAX (2 + LOG_ARGS_MAX * 4)        /* Maximal storlek på id samt argument. */
+
+/* Statiska variabler: */
+static volatile uint8_t buffer[LOG_BUFFER_SIZE]; /* Ringbuffert för meddelanden. */
+static volatile uint8_t head = 0;                /* Index där nästa byte lagras. */
+static volatile uint8_t tail = 0;                /* Index för äldsta ohämtade byte. */
+static volatile uint8_t recent_drops = 0;        /* Förlorade meddelanden sedan senaste ram. */
+static volatile uint16_t total_drops = 0;        /* Totalt antal förlorade meddelanden. */
+
+/* Nivå under körning per modul, initierad till trösklarna vid kompilering: */
+volatile uint8_t log_levels[LOG_MODULE_COUNT] =
+{
+   LOG_THRESHOLD_APP,
+   LOG_THRESHOLD_TIMER,
+   LOG_THRESHOLD_ADC,
+   LOG_THRESHOLD_EEPROM,
+   LOG_THRESHOLD_WDT,
+   LOG_THRESHOLD_SERIAL,
+   LOG_THRESHOLD_TASK
+};
+
+/* Trösklar vid kompilering per modul, indexerade via log_module: */
+static const uint8_t thresholds[LOG_MODULE_COUNT] PROGMEM =
+{
+   LOG_THRESHOLD_APP,
+   LOG_THRESHOLD_TIMER,
+   LOG_THRESHOLD_ADC,
+   LOG_THRESHOLD_EEPROM,
+   LOG_THRESHOLD_WDT,
+   LOG_THRESHOLD_SERIAL,
+   LOG_THRESHOLD_TASK
+};
+
+/* Namn på moduler, indexerade via log_module (lagras i programminnet): */
+static const char module_names[LOG_MODULE_COUNT][7] PROGMEM =
+{
+   "app",
+   "timer",
+   "adc",
+   "eeprom",
+   "wdt",
+   "serial",
+   "task"
+};
+
+/********************************************************************************
+* log_write: Lägger ett meddelande i loggbufferten med avbrott inaktiverade,
+*            så att meddelanden från avbrottsrutiner inte blandas med
+*            meddelanden från huvudloopen. Tidigare avbrottsstatus
+*            återställs efteråt, så att funktionen kan anropas från
+*            avbrottsrutiner.
+*
+*            - id  : Meddelandets id, dvs. formatsträngens adress.
+*            - args: Pekare till argumentens råa byte.
+*            - size: Antal byte argument.
+********************************************************************************/
+void log_write(const uint16_t id,
+               const void* args,
+               const uint8_t size)
+{
+   const uint8_t* bytes = (const uint8_t*)args;
+   const uint8_t length = size + 2;
+   const uint8_t sreg = SREG;
+   asm("CLI");
+
+   uint8_t index = head;
+   const uint8_t free_space = LOG_BUFFER_SIZE - 1 - (uint8_t)((index - tail) & LOG_BUFFER_MASK);
+
+   if (length + 1 > free_space || length > LOG_MESSAGE_SIZE_MAX)
+   {
+      if (recent_drops < UINT8_MAX) recent_drops++;
+      total_drops++;
+      SREG = sreg;
+      return;
+   }
+
+   buffer[index] = length;
+   index = (index + 1) & LOG_BUFFER_MASK;
+   buffer[index] = (uint8_t)id;
+   index = (index + 1) & LOG_BUFFER_MASK;
+   buffer[index] = (uint8_t)(id >> 8);
+   index = (index + 1) & LOG_BUFFER_MASK;
+
+   for (uint8_t i = 0; i < size; ++i)
+   {
+      buffer[index] = bytes[i];
+      index = (index + 1) & LOG_BUFFER_MASK;
+   }
+
+   head = index;
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* log_flush: Skickar samtliga meddelanden i loggbufferten. Varje meddelande
+*            kopieras ut med avbrott inaktiverade, varefter avbrott
+*            återaktiveras under själva utskriften. Antalet meddelanden som
+*            har slängts sedan föregående ram skickas först i ramen.
+********************************************************************************/
+void log_flush(void)
+{
+   uint8_t message[1 + LOG_MESSAGE_SIZE_MAX];
+
+   while (1)
+   {
+      asm("CLI");
+
+      if (head == tail)
+      {
+         asm("SEI");
+         break;
+      }
+
+      uint8_t index = tail;
+      const uint8_t length = buffer[index];
+      message[0] = recent_drops;
+      recent_drops = 0;
+
+      for (uint8_t i = 1; i <= length; ++i)
+      {
+         index = (index + 1) & LOG_BUFFER_MASK;
+         message[i] = buffer[index];
+      }
+
+      tail = (index + 1) & LOG_BUFFER_MASK;
+      asm("SEI");
+
+      frame_send(FRAME_TYPE_LOG, message, length + 1);
+   }
+   return;
+}
+
+/********************************************************************************
+* log_pending: Indikerar ifall loggbufferten innehåller meddelanden.
+********************************************************************************/
+bool log_pending(void)
+{
+   return head != tail;
+}
+
+/********************************************************************************
+* log_set_level: Sätter nivån under körning för angiven modul. Nivåer över
+*                LOG_LEVEL_DEBUG begränsas till LOG_LEVEL_DEBUG.
+*
+*                - module: Modulen vars nivå ska sättas.
+*                - level : Ny nivå (LOG_LEVEL_NONE - LOG_LEVEL_DEBUG).
+********************************************************************************/
+void log_set_level(const enum log_module module,
+                   const uint8_t level)
+{
+   if (module >= LOG_MODULE_COUNT) return;
+   log_levels[module] = level > LOG_LEVEL_DEBUG ? LOG_LEVEL_DEBUG : level;
+   return;
+}
+
+/********************************************************************************
+* log_find_module: Slår upp en modul via dess namn.
+*
+*                  - name  : Modulens namn (gemener).
+*                  - module: Pekare till variabel där modulen lagras.
+********************************************************************************/
+bool log_find_module(const char* name,
+                     enum log_module* module)
+{
+   for (uint8_t i = 0; i < LOG_MODULE_COUNT; ++i)
+   {
+      if (!strcmp_P(name, module_names[i]))
+      {
+         *module = (enum log_module)i;
+         return true;
+      }
+   }
+   return false;
+}
+
+/********************************************************************************
+* log_print_levels: Skriver ut aktuell nivå samt tröskel vid kompilering för
+*                   samtliga moduler, en modul per rad.
+********************************************************************************/
+void log_print_levels(void)
+{
+   for (uint8_t i = 0; i < LOG_MODULE_COUNT; ++i)
+   {
+      serial_print_string_P(module_names[i]);
+      SERIAL_PRINT_P(": level ");
+      serial_print_unsigned(log_levels[i]);
+      SERIAL_PRINT_P(", compiled ");
+      serial_print_unsigned(pgm_read_byte(&thresholds[i]));
+      serial_print_new_line();
+   }
+   return;
+}
+
+/********************************************************************************
+* log_dropped: Returnerar totalt antal meddelanden som har slängts på grund
+*              av full loggbuffert.
+********************************************************************************/
+uint16_t log_dropped(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint16_t drops = total_drops;
+   SREG = sreg;
+   return drops;
+}
\ No newline at end of file
@@ -0,0 +1,311 @@
+/********************************************************************************
+* log.h: Innehåller drivrutiner för fördröjd binär loggning via seriell
+*        överföring, där meddelanden formateras på värddatorn i stället för
+*        på mikrodatorn.
+*
+*        Varje anrop av makrot LOG lagrar formatsträngen i programminnet via
+*        PSTR, där strängens adress i programminnet utgör meddelandets id.
+*        Id:t är därmed en konstant som sätts av länkaren vid kompilering.
+*        Vid anrop kopieras endast id samt argumentens råa byte till en
+*        ringbuffert, vilket tar några tiotal klockcykler. Formatering sker
+*        aldrig på mikrodatorn. Bufferten töms i huvudloopen via log_flush,
+*        där varje meddelande skickas som en ram via frame.h med typen
+*        FRAME_TYPE_LOG:
+*
+*        [antal förlorade meddelanden (1)] [id (2)] [argument]...
+*
+*        Värddatorn slår upp formatsträngen på adressen id i den kompilerade
+*        ELF-filen, som därmed utgör formattabellen, och formaterar
+*        meddelandet via host/log_decode.c.
+*
+*        Argumenten lagras efter heltalskonvertering, dvs. som int (2 byte)
+*        för heltal upp till 16 bitar, som long (4 byte) för 32-bitars
+*        heltal samt som float (4 byte) för flyttal. Följande konverteringar
+*        stöds därmed i formatsträngen: %d, %i, %u, %x, %X, %c samt %o för
+*        heltal upp till 16 bitar, motsvarande med l-prefix för 32-bitars
+*        heltal, samt %f, %e och %g för flyttal. Pekare och textsträngar
+*        (%s, %p) stöds inte, eftersom dessa pekar på minne som inte finns
+*        på värddatorn, och inte heller 64-bitars heltal (%ll), som avvisas
+*        vid kompilering. Högst LOG_ARGS_MAX argument stöds per anrop.
+*
+*        Skrivning till bufferten sker med avbrott inaktiverade under själva
+*        kopieringen, vilket gör LOG säker att anropa från både huvudloopen
+*        och avbrottsrutiner. Anropet blockerar aldrig. Ifall bufferten är
+*        full slängs meddelandet och räknas som förlorat.
+*
+*        Meddelanden loggas normalt via makrona LOG_ERROR, LOG_WARN, LOG_INFO
+*        samt LOG_DEBUG, som anger modul och allvarlighetsgrad. Varje modul
+*        har en tröskel vid kompilering (LOG_THRESHOLD_<modul>, default
+*        LOG_THRESHOLD_DEFAULT), där meddelanden över tröskeln ersätts av
+*        en tom sats redan av preprocessorn. Dessa meddelanden genererar
+*        därmed varken kod eller formatsträngar i programminnet, och deras
+*        argument beräknas inte. Trösklar kan sättas per kompilering, till
+*        exempel via -DLOG_THRESHOLD_TIMER=4 (värdet måste vara en siffra
+*        0 - 4). Meddelanden som finns kvar filtreras även under körning
+*        mot en nivå per modul, se log_set_level, vilket kostar en jämförelse
+*        per anrop. Formatsträngen inleds med nivå och modul, exempelvis
+*        "W WDT: ", vilket endast kostar programminne.
+*
+*        Exempel på användning:
+*
+*        ISR (WDT_vect)
+*        {
+*           LOG_WARN(WDT, "Watchdog timeout %u of %u",
+*                    ++num_timeouts, TIMEOUT_MAX);
+*        }
+********************************************************************************/
+#ifndef LOG_H_
+#define LOG_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+#include <avr/pgmspace.h>
+
+/* Makrodefinitioner: */
+#ifndef LOG_ENABLED
+#define LOG_ENABLED 1 /* 0 för att ta bort samtliga loggmeddelanden vid kompilering. */
+#endif
+
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 64 /* Storlek på loggbufferten (tvåpotens, max 256). */
+#endif
+
+#define LOG_ARGS_MAX 4 /* Maximalt antal argument per meddelande. */
+
+/* Allvarlighetsgrader, där lägre värde är allvarligare: */
+#define LOG_LEVEL_NONE 0  /* Inga meddelanden. */
+#define LOG_LEVEL_ERROR 1 /* Fel som påverkar systemets funktion. */
+#define LOG_LEVEL_WARN 2  /* Oväntade händelser som systemet hanterar. */
+#define LOG_LEVEL_INFO 3  /* Normala händelser av intresse. */
+#define LOG_LEVEL_DEBUG 4 /* Detaljerad felsökning. */
+
+/* Trösklar vid kompilering per modul (siffra 0 - 4): */
+#ifndef LOG_THRESHOLD_DEFAULT
+#define LOG_THRESHOLD_DEFAULT 3 /* LOG_LEVEL_INFO. */
+#endif
+
+#ifndef LOG_THRESHOLD_APP
+#define LOG_THRESHOLD_APP LOG_THRESHOLD_DEFAULT
+#endif
+
+#ifndef LOG_THRESHOLD_TIMER
+#define LOG_THRESHOLD_TIMER LOG_THRESHOLD_DEFAULT
+#endif
+
+#ifndef LOG_THRESHOLD_ADC
+#define LOG_THRESHOLD_ADC LOG_THRESHOLD_DEFAULT
+#endif
+
+#ifndef LOG_THRESHOLD_EEPROM
+#define LOG_THRESHOLD_EEPROM LOG_THRESHOLD_DEFAULT
+#endif
+
+#ifndef LOG_THRESHOLD_WDT
+#define LOG_THRESHOLD_WDT LOG_THRESHOLD_DEFAULT
+#endif
+
+#ifndef LOG_THRESHOLD_SERIAL
+#define LOG_THRESHOLD_SERIAL LOG_THRESHOLD_DEFAULT
+#endif
+
+#ifndef LOG_THRESHOLD_TASK
+#define LOG_THRESHOLD_TASK LOG_THRESHOLD_DEFAULT
+#endif
+
+/********************************************************************************
+* log_module: Enumeration för moduler med separata loggnivåer. Namnen efter
+*             LOG_MODULE_ används som modul i makrona LOG_ERROR med flera.
+********************************************************************************/
+enum log_module
+{
+   LOG_MODULE_APP,    /* Applikationen (main.c, isr.c samt commands.c). */
+   LOG_MODULE_TIMER,  /* Hårdvaru- och mjukvarutimers. */
+   LOG_MODULE_ADC,    /* AD-omvandling samt sensorer. */
+   LOG_MODULE_EEPROM, /* EEPROM-minnet. */
+   LOG_MODULE_WDT,    /* Watchdog-timern. */
+   LOG_MODULE_SERIAL, /* Seriell överföring samt kommandoskalet. */
+   LOG_MODULE_TASK,   /* Schemaläggaren för tasks. */
+   LOG_MODULE_COUNT   /* Antalet moduler. */
+};
+
+/* Aktuell nivå per modul under körning, se log_set_level: */
+extern volatile uint8_t log_levels[LOG_MODULE_COUNT];
+
+/********************************************************************************
+* LOG_ERROR, LOG_WARN, LOG_INFO, LOG_DEBUG: Loggar ett meddelande för angiven
+*                                           modul med angiven
+*                                           allvarlighetsgrad. Ifall nivån
+*                                           överstiger modulens tröskel vid
+*                                           kompilering genereras ingen kod.
+*
+*                                           - module: Modulens namn, t.ex. WDT.
+*                                           - format: Formatsträngen.
+*                                           - ...   : Argument (högst fyra).
+********************************************************************************/
+#define LOG_ERROR(module, format, ...) LOG_AT(module, ERROR, format, ##__VA_ARGS__)
+#define LOG_WARN(module, format, ...) LOG_AT(module, WARN, format, ##__VA_ARGS__)
+#define LOG_INFO(module, format, ...) LOG_AT(module, INFO, format, ##__VA_ARGS__)
+#define LOG_DEBUG(module, format, ...) LOG_AT(module, DEBUG, format, ##__VA_ARGS__)
+
+/* Val mellan LOG_EMIT och LOG_DISCARD via tröskel och nivå (LOG_GATE_<tröskel>_<nivå>): */
+#define LOG_AT(module, level, format, ...) \
+   LOG_CONCAT(LOG_GATE_, LOG_CONCAT(LOG_THRESHOLD_##module, LOG_CONCAT(_, LOG_LEVEL_##level))) \
+   (module, level, format, ##__VA_ARGS__)
+
+#define LOG_EMIT(module, level, format, ...) do \
+{ \
+   if (log_levels[LOG_MODULE_##module] >= LOG_LEVEL_##level) \
+   { \
+      LOG(LOG_PREFIX_##level #module ": " format, ##__VA_ARGS__); \
+   } \
+} while (0)
+
+#define LOG_DISCARD(module, level, format, ...) do { } while (0)
+
+#define LOG_PREFIX_ERROR "E "
+#define LOG_PREFIX_WARN "W "
+#define LOG_PREFIX_INFO "I "
+#define LOG_PREFIX_DEBUG "D "
+
+#define LOG_GATE_0_1 LOG_DISCARD
+#define LOG_GATE_0_2 LOG_DISCARD
+#define LOG_GATE_0_3 LOG_DISCARD
+#define LOG_GATE_0_4 LOG_DISCARD
+#define LOG_GATE_1_1 LOG_EMIT
+#define LOG_GATE_1_2 LOG_DISCARD
+#define LOG_GATE_1_3 LOG_DISCARD
+#define LOG_GATE_1_4 LOG_DISCARD
+#define LOG_GATE_2_1 LOG_EMIT
+#define LOG_GATE_2_2 LOG_EMIT
+#define LOG_GATE_2_3 LOG_DISCARD
+#define LOG_GATE_2_4 LOG_DISCARD
+#define LOG_GATE_3_1 LOG_EMIT
+#define LOG_GATE_3_2 LOG_EMIT
+#define LOG_GATE_3_3 LOG_EMIT
+#define LOG_GATE_3_4 LOG_DISCARD
+#define LOG_GATE_4_1 LOG_EMIT
+#define LOG_GATE_4_2 LOG_EMIT
+#define LOG_GATE_4_3 LOG_EMIT
+#define LOG_GATE_4_4 LOG_EMIT
+
+#define LOG_CONCAT(a, b) LOG_CONCAT_(a, b)
+#define LOG_CONCAT_(a, b) a##b
+
+#if LOG_ENABLED
+
+/********************************************************************************
+* LOG: Loggar ett meddelande med angiven formatsträng samt upp till fyra
+*      argument, oavsett modul och nivå. Används normalt via LOG_ERROR med
+*      flera, men kan även användas direkt. Argumenten lagras i en packad
+*      strukt, där varje fält har argumentets typ efter heltalskonvertering
+*      (via unärt plus), så att mikrodatorn och värddatorn är överens om
+*      varje arguments storlek.
+*      Argument större än fyra byte, exempelvis 64-bitars heltal (%ll),
+*      avvisas vid kompilering. Utan argument lagras endast id.
+*
+*      - format: Formatsträngen (textlitteral), se ovan för konverteringar.
+*      - ...   : Argument till formatsträngen.
+********************************************************************************/
+#define LOG(format, ...) LOG_CONCAT(LOG_WRITE_, LOG_NUM_ARGS(__VA_ARGS__))(format, ##__VA_ARGS__)
+
+/* Meddelanden utan argument, där endast id lagras: */
+#define LOG_WRITE_0(format) do \
+{ \
+   log_write((uint16_t)(uintptr_t)PSTR(format), 0, 0); \
+} while (0)
+
+/* Meddelanden med argument, där argumenten lagras i en packad strukt: */
+#define LOG_WRITE_1 LOG_WRITE_ARGS
+#define LOG_WRITE_2 LOG_WRITE_ARGS
+#define LOG_WRITE_3 LOG_WRITE_ARGS
+#define LOG_WRITE_4 LOG_WRITE_ARGS
+#define LOG_WRITE_ARGS(format, ...) do \
+{ \
+   LOG_CHECKS(__VA_ARGS__) \
+   const struct __attribute__((packed)) { LOG_FIELDS(__VA_ARGS__) } log_args_ = { __VA_ARGS__ }; \
+   log_write((uint16_t)(uintptr_t)PSTR(format), &log_args_, sizeof(log_args_)); \
+} while (0)
+
+/* Makron för kontroll av att varje argument ryms i fyra byte: */
+#define LOG_CHECKS(...) LOG_CONCAT(LOG_CHECKS_, LOG_NUM_ARGS(__VA_ARGS__))(__VA_ARGS__)
+#define LOG_CHECK(a) _Static_assert(sizeof(+(a)) <= 4, "LOG arguments larger than 4 bytes (e.g. %ll) are not supported!");
+#define LOG_CHECKS_1(a) LOG_CHECK(a)
+#define LOG_CHECKS_2(a, b) LOG_CHECKS_1(a) LOG_CHECK(b)
+#define LOG_CHECKS_3(a, b, c) LOG_CHECKS_2(a, b) LOG_CHECK(c)
+#define LOG_CHECKS_4(a, b, c, d) LOG_CHECKS_3(a, b, c) LOG_CHECK(d)
+
+/* Makron för deklaration av ett fält per argument: */
+#define LOG_FIELDS(...) LOG_CONCAT(LOG_FIELDS_, LOG_NUM_ARGS(__VA_ARGS__))(__VA_ARGS__)
+#define LOG_FIELDS_1(a) __typeof__(+(a)) a0;
+#define LOG_FIELDS_2(a, b) LOG_FIELDS_1(a) __typeof__(+(b)) a1;
+#define LOG_FIELDS_3(a, b, c) LOG_FIELDS_2(a, b) __typeof__(+(c)) a2;
+#define LOG_FIELDS_4(a, b, c, d) LOG_FIELDS_3(a, b, c) __typeof__(+(d)) a3;
+#define LOG_NUM_ARGS(...) LOG_NUM_ARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define LOG_NUM_ARGS_(_0, _1, _2, _3, _4, n, ...) n
+
+#else
+
+#define LOG(format, ...) do { } while (0)
+
+#endif /* LOG_ENABLED */
+
+/********************************************************************************
+* log_write: Lägger ett meddelande i loggbufferten. Anropas via makrot LOG.
+*            Ifall meddelandet inte ryms i bufferten slängs det.
+*
+*            - id  : Meddelandets id, dvs. formatsträngens adress.
+*            - args: Pekare till argumentens råa byte.
+*            - size: Antal byte argument.
+********************************************************************************/
+void log_write(const uint16_t id,
+               const void* args,
+               const uint8_t size);
+
+/********************************************************************************
+* log_flush: Skickar samtliga meddelanden i loggbufferten. Anropas från
+*            huvudloopen, lämpligen som en task med log_pending som
+*            väckningsvillkor (se task.h).
+********************************************************************************/
+void log_flush(void);
+
+/********************************************************************************
+* log_pending: Indikerar ifall loggbufferten innehåller meddelanden.
+********************************************************************************/
+bool log_pending(void);
+
+/********************************************************************************
+* log_set_level: Sätter nivån under körning för angiven modul, där
+*                meddelanden med högre nivå än angiven filtreras bort.
+*                Meddelanden som har tagits bort vid kompilering kan inte
+*                aktiveras. LOG_LEVEL_NONE stänger av modulen helt.
+*
+*                - module: Modulen vars nivå ska sättas.
+*                - level : Ny nivå (LOG_LEVEL_NONE - LOG_LEVEL_DEBUG).
+********************************************************************************/
+void log_set_level(const enum log_module module,
+                   const uint8_t level);
+
+/********************************************************************************
+* log_find_module: Slår upp en modul via dess namn, exempelvis "wdt", där
+*                  versaler och gemener ses som olika. Ifall modulen inte
+*                  finns returneras false.
+*
+*                  - name  : Modulens namn (gemener).
+*                  - module: Pekare till variabel där modulen lagras.
+********************************************************************************/
+bool log_find_module(const char* name,
+                     enum log_module* module);
+
+/********************************************************************************
+* log_print_levels: Skriver ut aktuell nivå samt tröskel vid kompilering för
+*                   samtliga moduler i klartext via seriell överföring.
+********************************************************************************/
+void log_print_levels(void);
+
+/********************************************************************************
+* log_dropped: Returnerar totalt antal meddelanden som har slängts på grund
+*              av full loggbuffert.
+********************************************************************************/
+uint16_t log_dropped(void);
+
+#endif /* LOG_H_ */
\ No newline at end of file
@@ -1,76 +1,150 @@
-/********************************************************************************
-* main.c: Demonstration av inbyggt system innefattande PWM-styrning av
-*         lysdioder anslutna till pin 8 - 10 (PORTB0 - PORTB2) via en
-*         potentiometer ansluten till analog pin A0 (PORTB). Maximalt fem
-*         Watchdog-timeouts (sker efter 8192 ms utan Watchdog reset) fr ske
-*         innan systemet lses.
-*
-*         Fr att genomgra Watchdog reset kan anvndaren trycka p en
-*         tryckknapp ansluten till pin 13 (PORTB5). Efter fem timeouts lses
-*         systemet, dr det enda som sker r att en lysdiod ansluten till
-*         pin 8 (PORTB0) blinkar var 50:e millisekund via Timer 1.
-*
-*         Utskrift sker via seriell verfring efter varje Watchdog timeout,
-*         vid Watchdog reset samt vid lsning av systemet. Fr att undvika
-*         multipla avbrott orsakat av kontaktstudsar inaktiveras PCI-avbrott
-*         p I/O-port B i 300 millisekunder efter nedtryckning, implementerat
-*         via Timer 0.
+/********************************************************************************
+* main.c: Demonstration av inbyggt system innefattande PWM-styrning av
+*         lysdioder anslutna till pin 8 - 10 (PORTB0 - PORTB2) via en
+*         potentiometer ansluten till analog pin A0 (PORTB). Maximalt fem
+*         Watchdog-timeouts (sker efter 8192 ms utan Watchdog reset) får ske
+*         innan systemet låses.
+*
+*         För att genomgöra Watchdog reset kan användaren trycka på en
+*         tryckknapp ansluten till pin 13 (PORTB5). Efter fem timeouts låses
+*         systemet, där det enda som sker är att en lysdiod ansluten till
+*         pin 8 (PORTB0) blinkar var 50:e millisekund via mjukvarutimer t1.
+*
+*         Utskrift sker via seriell överföring efter varje Watchdog timeout,
+*         vid Watchdog reset samt vid låsning av systemet. För att undvika
+*         multipla avbrott orsakat av kontaktstudsar inaktiveras PCI-avbrott
+*         på I/O-port B i 300 millisekunder efter nedtryckning, implementerat
+*         via mjukvarutimer t0.
 ********************************************************************************/
 #include "header.h"
 
 /* Deklaration av globala objekt: */
 struct led l1;
 struct button b1;
-struct timer t0, t1;
-
-/********************************************************************************
-* setup: Initierar systemet enligt fljande:
-
-*        1. Initierar lysdiod l1 ansluten till pin 8 (PORTB0).
-*
-*        2. Initierar tryckknapp b1 ansluten till pin 13 (PORTB5) och
-*           aktiverar avbrott vid nedtryckning/uppslppning.
-*           Avbrottsvektor fr avbrottsrutinen r PCINT0_vect.
-*
-*        3. Initierar timer t0 till den 8-bitars timerkretsen Timer 0, som
-*           lper ut efter 300 millisekunder efter aktivering i Normal Mode.
-*           Avbrottsvektor fr avbrottsrutinen r TIMER0_OVF_vect.
-*
-*        4. Initierar timer t1 till den 16-bitars timerkretsen Timer 1, som
-*           lper ut efter 50 millisekunder efter aktivering i CTC Mode
-*           (rknar upp till 256 och fungerar drmed som en 8-bitars timer).
-*           Avbrottsvektor fr avbrottsrutinen r TIMER0_COMPA_vect.
-*
-*        5. Initierar seriell verfring med en baud rate p 9600 kbps fr
-*           att mjliggra utskrift till seriell terminal.
-*
-*        6. Initierar Watchdog-timern med en timeout p 8192 ms. Avbrott
-*           aktiveras s att timeout medfr avbrott. Avbrottsvektorn fr
-*           motsvarande avbrottsrutin r WDT_vect.
+struct soft_timer t0, t1;
+struct pwm p1;
+struct task debounce_task, lockdown_task;
+uint32_t timer_period_ms[2] = { DEBOUNCE_TIME_MS, BLINK_PERIOD_MS };
+
+/* Statiska variabler: */
+static struct task event_task; /* Task för hantering av händelser från avbrottsrutiner. */
+static struct task shell_task; /* Task för kommandoskalet via seriell överföring. */
+static struct task log_task;   /* Task för utskrift av binära loggmeddelanden. */
+static struct task telemetry_task;          /* Task för strömning av AD-resultat. */
+static struct adc scan_inputs[ADC_CHANNELS]; /* Kanaler A0 - A5 för avläsning av ringbuffertarna. */
+
+/* Statiska funktioner: */
+static void handle_events(void* arg);
+static void handle_shell(void* arg);
+static void handle_log(void* arg);
+static void handle_telemetry(void* arg);
+static bool adc_samples_pending(void);
+static void handle_debounce(void* arg);
+static void handle_lockdown(void* arg);
+static void debounce_elapsed(void* arg);
+static void blink(void* arg);
+
+/********************************************************************************
+* setup: Initierar systemet enligt följande:
+
+*        1. Initierar lysdiod l1 ansluten till pin 8 (PORTB0).
+*
+*        2. Initierar PWM-kontroller p1 för lysdiod l1 med periodtiden
+*           10 ms och analog insignal A0. PWM-generering startas utan
+*           blockering via kommandot pwm (se commands.c).
+*
+*        3. Initierar tryckknapp b1 ansluten till pin 13 (PORTB5) och
+*           aktiverar avbrott vid nedtryckning/uppsläppning.
+*           Avbrottsvektor för avbrottsrutinen är PCINT0_vect.
+*
+*        4. Initierar timerhjulet för mjukvarutimers i tickless-läge, där
+*           Timer 1 utgör systemets tidsbas (se sysclock.h). I huvudloopen
+*           sover processorn i Idle Mode mellan varje händelse.
+*
+*        5. Initierar mjukvarutimer t0, som återaktiverar PCI-avbrott 300
+*           millisekunder efter nedtryckning, samt mjukvarutimer t1, som
+*           togglar lysdiod l1 var 50:e millisekund efter låsning av
+*           systemet. Missade blinkperioder slås ihop och räknas som
+*           overruns, se kommandot stats. Timrarna startas av varsin
+*           task, som signaleras från avbrottsrutinerna för PCI-avbrott
+*           respektive Watchdog timeout. Inga timergenererade avbrott
+*           utöver tidsbasens används därmed.
+*
+*        6. Initierar schemaläggaren för tasks i huvudloopen, där
+*           händelser postade från avbrottsrutinerna hanteras i en task
+*           som väcks när händelsekön inte är tom (se task.h).
+*
+*        7. Initierar seriell överföring med 9600 baud för
+*           att möjliggöra utskrift till seriell terminal. Mottagna tecken
+*           tolkas av kommandoskalet (se shell.h samt commands.c) i en
+*           task som väcks när tecken har mottagits. Binära loggmeddelanden
+*           (se log.h) skickas i en task som väcks när loggbufferten inte
+*           är tom. Resultat från kontinuerlig eller triggad omvandling
+*           (kommandona scan respektive trig) strömmas som binär telemetri
+*           (se telemetry.h) i en task som väcks när någon kanals
+*           ringbuffert innehåller resultat, där kanalnumret utgör
+*           telemetrikanal.
+*
+*        8. Initierar Watchdog-timern med en timeout på 8192 ms. Avbrott
+*           aktiveras så att timeout medför avbrott. Avbrottsvektorn för
+*           motsvarande avbrottsrutin är WDT_vect.
 ********************************************************************************/
 void setup(void)
 {
    led_init(&l1, 8);
+   pwm_init(&p1, 0, PWM_PERIOD_US, &l1, led_on, led_off);
    button_init(&b1, 13);
    button_enable_interrupt(&b1);
 
-   timer_init(&t0, TIMER_SEL_0, 300);
-   timer_init(&t1, TIMER_SEL_1, 50);
+   soft_timer_wheel_init_tickless();
+   soft_timer_init(&t0, debounce_elapsed, 0);
+   soft_timer_init(&t1, blink, &l1);
+   soft_timer_set_coalesce(&t1, true);
+
+   task_scheduler_init();
+   task_init(&debounce_task, "debounce", handle_debounce, 0);
+   task_add(&debounce_task);
+   task_init(&lockdown_task, "lockdown", handle_lockdown, 0);
+   task_add(&lockdown_task);
+   task_init(&event_task, "events", handle_events, 0);
+   task_set_condition(&event_task, event_pending);
+   task_add(&event_task);
 
    serial_init(9600);
+   commands_init();
+   task_init(&shell_task, "shell", handle_shell, 0);
+   task_set_condition(&shell_task, serial_rx_available);
+   task_add(&shell_task);
+   task_init(&log_task, "log", handle_log, 0);
+   task_set_condition(&log_task, log_pending);
+   task_add(&log_task);
+
+   for (uint8_t i = 0; i < ADC_CHANNELS; ++i)
+   {
+      adc_init(&scan_inputs[i], i);
+   }
+
+   telemetry_init();
+   task_init(&telemetry_task, "telemetry", handle_telemetry, 0);
+   task_set_condition(&telemetry_task, adc_samples_pending);
+   task_add(&telemetry_task);
 
    wdt_init(WDT_TIMEOUT_8192_MS);
    wdt_enable_interrupt();
    return;
 }
 
-/********************************************************************************
-* main: Initierar systemet vid start. Watchdog timeout sker sedan kontinuerligt
-*       var 8192:e millisekund om inte anvndaren under denna tid terstller
-*       Watchdog-timern, vilket stadkommes genom att trycka ned tryckknapp
-*       b1 ansluten till pin 13 (PORTB5). Efter fem timeouts lses systemet.
-*       Lysdiod l1 ansluten till pin 8 (PORTB0) kommer d kontinuerligt blinka
-*       var 50:e millisekund tills en total systemterstllning genomfrs.
+/********************************************************************************
+* main: Initierar systemet vid start. Watchdog timeout sker sedan kontinuerligt
+*       var 8192:e millisekund om inte användaren under denna tid återställer
+*       Watchdog-timern, vilket åstadkommes genom att trycka ned tryckknapp
+*       b1 ansluten till pin 13 (PORTB5). Efter fem timeouts låses systemet.
+*       Lysdiod l1 ansluten till pin 8 (PORTB0) kommer då kontinuerligt blinka
+*       var 50:e millisekund tills en total systemåterställning genomförs.
+*
+*       Mellan varje händelse sover processorn i Idle Mode. Efter varje
+*       uppvaknande körs de tasks som är redo, såsom hantering av händelser
+*       postade från avbrottsrutinerna samt eventuella mjukvarutimers.
 ********************************************************************************/
 int main(void)
 {
@@ -78,9 +152,172 @@ int main(void)
    
    while (1)
    {
-      
+      task_run();
+      soft_timer_sleep();
    }
 
    return 0;
 }
 
+/********************************************************************************
+* handle_events: Taskfunktion som hämtar samtliga händelser som har postats
+*                från avbrottsrutinerna och genomför motsvarande utskrift i
+*                ansluten seriell terminal. Utskriften sker därmed i
+*                huvudloopen, där den inte blockerar övriga avbrott.
+*
+*                - arg: Används ej.
+********************************************************************************/
+static void handle_events(void* arg)
+{
+   struct event event;
+   (void)arg;
+
+   while (event_get(&event))
+   {
+      switch (event.id)
+      {
+         case APP_EVENT_WDT_RESET:
+            SERIAL_PRINT_P("Watchdog timer reset!\n");
+            break;
+         case APP_EVENT_WDT_TIMEOUT:
+            SERIAL_PRINT_P("Number of timeouts: ");
+            serial_print_unsigned(event.payload);
+            serial_print_new_line();
+            break;
+         case APP_EVENT_LOCKDOWN:
+            SERIAL_PRINT_P("Maximum number of timeouts has elapsed!\n");
+            SERIAL_PRINT_P("System lockdown!\n");
+            break;
+         default:
+            break;
+      }
+   }
+   return;
+}
+
+/********************************************************************************
+* handle_shell: Taskfunktion som låter kommandoskalet hantera mottagna tecken.
+*
+*               - arg: Används ej.
+********************************************************************************/
+static void handle_shell(void* arg)
+{
+   (void)arg;
+   shell_poll();
+   return;
+}
+
+/********************************************************************************
+* handle_log: Taskfunktion som skickar samtliga binära loggmeddelanden.
+*
+*             - arg: Används ej.
+********************************************************************************/
+static void handle_log(void* arg)
+{
+   (void)arg;
+   log_flush();
+   return;
+}
+
+/********************************************************************************
+* handle_telemetry: Taskfunktion som hämtar samtliga resultat ur ringbuffertarna
+*                   för kontinuerlig eller triggad omvandling och lägger till
+*                   dem som telemetriposter, där kanalnumret utgör
+*                   telemetrikanal. Ramar skickas när de är fulla; när
+*                   omvandlingen har stoppats skickas även sista ramen.
+*
+*                   Vid 9600 baud ryms cirka 160 resultat per sekund, varför
+*                   högre samplingshastighet medför att resultat skrivs över
+*                   i ringbuffertarna (se kommandot scan).
+*
+*                   - arg: Används ej.
+********************************************************************************/
+static void handle_telemetry(void* arg)
+{
+   uint16_t value;
+   (void)arg;
+
+   for (uint8_t i = 0; i < ADC_CHANNELS; ++i)
+   {
+      while (adc_buffer_read(&scan_inputs[i], &value))
+      {
+         telemetry_add_uint16(i, value);
+      }
+   }
+
+   if (!adc_scan_running())
+   {
+      telemetry_flush();
+   }
+   return;
+}
+
+/********************************************************************************
+* adc_samples_pending: Väckningsvillkor för telemetritasken, som indikerar
+*                      ifall någon kanals ringbuffert innehåller resultat.
+********************************************************************************/
+static bool adc_samples_pending(void)
+{
+   for (uint8_t i = 0; i < ADC_CHANNELS; ++i)
+   {
+      if (adc_buffer_count(&scan_inputs[i])) return true;
+   }
+   return false;
+}
+
+
+/********************************************************************************
+* handle_debounce: Taskfunktion som startar timer t0 efter nedtryckning av
+*                  tryckknapp b1. Tasken signaleras från avbrottsrutinen för
+*                  PCI-avbrott, eftersom mjukvarutimers inte får startas
+*                  från avbrottsrutiner.
+*
+*                  - arg: Används ej.
+********************************************************************************/
+static void handle_debounce(void* arg)
+{
+   (void)arg;
+   soft_timer_start(&t0, timer_period_ms[0]);
+   return;
+}
+
+/********************************************************************************
+* handle_lockdown: Taskfunktion som låser systemet efter maximalt antal
+*                  Watchdog timeouts. Timer t0 stoppas, PWM-kontroller p1
+*                  inaktiveras och timer t1 startas, varefter lysdiod l1
+*                  blinkar tills systemet återställs.
+*
+*                  - arg: Används ej.
+********************************************************************************/
+static void handle_lockdown(void* arg)
+{
+   (void)arg;
+   soft_timer_stop(&t0);
+   pwm_disable(&p1);
+   soft_timer_start_periodic(&t1, timer_period_ms[1]);
+   return;
+}
+
+/********************************************************************************
+* debounce_elapsed: Callbackrutin för timer t0, som återaktiverar PCI-avbrott
+*                   på I/O-port B när kontaktstudsarna har klingat av.
+*
+*                   - arg: Används ej.
+********************************************************************************/
+static void debounce_elapsed(void* arg)
+{
+   (void)arg;
+   enable_pin_change_interrupt(IO_PORTB);
+   return;
+}
+
+/********************************************************************************
+* blink: Callbackrutin för timer t1, som togglar angiven lysdiod.
+*
+*        - arg: Pekare till lysdioden som ska togglas.
+********************************************************************************/
+static void blink(void* arg)
+{
+   led_toggle((struct led*)arg);
+   return;
+}
\ No newline at end of file
@@ -1,103 +1,220 @@
-/********************************************************************************
-* pwm.c: Innehller drivrutiner fr PWM-styrning av en godtycklig utenhet,
-*        ssom en eller flera lysdioder.
-********************************************************************************/
-#include "pwm.h"
-
-/* Statiska funktioner: */
-static inline void pwm_run_cycle(struct pwm* self);
-
-/********************************************************************************
-* pwm_init: Initierar PWM-kontroller fr PWM-styrning av angiven utenhet via
-*           angiven analog insignal.
-*
-*           - self       : Pekare till PWM-kontrollern som ska initieras.
-*           - input_pin  : Pekare till analog pin som utgr insignal.
-*           - period_us  : Periodtid fr PWM mtt i mikrosekunder.
-*           - output     : Pekare till utenheten som ska styras med PWM.
-*           - output_high: Funktionspekare fr aktivering av angiven utenhet.
-*           - output_low : Funktionspekare fr inaktivering av angiven utenhet.
-********************************************************************************/
-void pwm_init(struct pwm* self,
-              const uint8_t input_pin,
-              const uint16_t period_us,
-              void* output,
-              void* output_high,
-              void* output_low)
-{
-   adc_init(&self->input, input_pin);
-   self->period_us = period_us;
-   self->output = output;
-   self->output_high = output_high;
-   self->output_low = output_low;
-   self->enabled = true;
-   return;
-}
-
-/********************************************************************************
-* pwm_clear: Nollstller angiven PWM-kontroller.
-*
-*            - self: Pekare till PWM-kontrollern som ska nollstllas.
-********************************************************************************/
-void pwm_clear(struct pwm* self)
-{
-   adc_clear(&self->input);
-   self->period_us = 0;
-   self->output = 0;
-   self->output_high = 0;
-   self->output_low = 0;
-   self->enabled = false;
-   return;
-}
-
-/********************************************************************************
-* pwm_run: Kr angiven PWM-kontroller under en period och styr ansluten utenhet,
-*          frutsatt att PWM-kontrollern r aktiverad.
-*
-*          - self: Pekare till PWM-kontrollern som ska kras.
-********************************************************************************/
-void pwm_run(struct pwm* self)
-{
-   if (!self->enabled) return;
-   adc_get_pwm_values(&self->input, self->period_us);
-   pwm_run_cycle(self);
-   return;
-}
-
-/********************************************************************************
-* pwm_run_with_duty_cycle: Kr angiven PWM-kontroller under en period och styr
-*                          ansluten utenhet med angiven duty cycle, frutsatt
-*                          att PWM-kontrollern r aktiverad. Duty cycle mste
-*                          anges som ett flyttal mellan 0 - 1, vilket motsvarar
-*                          0 - 100 % duty cycle.
-*
-*         -                - self: Pekare till PWM-kontrollern som ska kras.
-*                          - duty_cycle: Duty cycle, allts andelen av aktuell
-*                                        periodtid som ansluten utenhet ska
-*                                        vara aktiverad, mellan 0 - 1.
-********************************************************************************/
-void pwm_run_with_duty_cycle(struct pwm* self, 
-                             const double duty_cycle)
-{
-   if (!self->enabled || duty_cycle < 0 || duty_cycle > 1) return;
-   self->input.pwm_on_us = (uint16_t)(self->period_us * duty_cycle + 0.5);
-   self->input.pwm_off_us = self->period_us - self->input.pwm_on_us;
-   pwm_run_cycle(self);
-   return;
-}
-
-/********************************************************************************
-* pwm_run_cycle: Kr utenhet ansluten till angiven PWM-kontroller under en 
-*                PWM-period med befintliga PWM-vrden.
-*
-*                - self: Pekare till PWM-kontrollern vars anslutna utenhet
-*                        ska kras.
-********************************************************************************/
-static inline void pwm_run_cycle(struct pwm* self)
-{
-   self->output_high(self->output);
-   delay_us(self->input.pwm_on_us);
-   self->output_low(self->output);
-   delay_us(self->input.pwm_off_us);
-   return;
+/********************************************************************************
+* pwm.c: Innehåller drivrutiner för PWM-styrning av en godtycklig utenhet,
+*        såsom en eller flera lysdioder.
+********************************************************************************/
+#include "pwm.h"
+
+/* Statiska funktioner: */
+static inline void pwm_run_cycle(struct pwm* self);
+static inline void pwm_set_duty_cycle_q16(struct pwm* self,
+                                          const uint16_t duty_q16);
+static void pwm_timer_callback(void* arg);
+
+/********************************************************************************
+* pwm_init: Initierar PWM-kontroller för PWM-styrning av angiven utenhet via
+*           angiven analog insignal.
+*
+*           - self       : Pekare till PWM-kontrollern som ska initieras.
+*           - input_pin  : Pekare till analog pin som utgör insignal.
+*           - period_us  : Periodtid för PWM mätt i mikrosekunder.
+*           - output     : Pekare till utenheten som ska styras med PWM.
+*           - output_high: Funktionspekare för aktivering av angiven utenhet.
+*           - output_low : Funktionspekare för inaktivering av angiven utenhet.
+********************************************************************************/
+void pwm_init(struct pwm* self,
+              const uint8_t input_pin,
+              const uint16_t period_us,
+              void* output,
+              void* output_high,
+              void* output_low)
+{
+   adc_init(&self->input, input_pin);
+   self->period_us = period_us;
+   self->output = output;
+   self->output_high = output_high;
+   self->output_low = output_low;
+   soft_timer_init(&self->timer, pwm_timer_callback, self);
+   self->on_ms = 0;
+   self->off_ms = 0;
+   self->output_on = false;
+   self->enabled = true;
+   return;
+}
+
+/********************************************************************************
+* pwm_clear: Nollställer angiven PWM-kontroller.
+*
+*            - self: Pekare till PWM-kontrollern som ska nollställas.
+********************************************************************************/
+void pwm_clear(struct pwm* self)
+{
+   adc_clear(&self->input);
+   soft_timer_stop(&self->timer);
+   self->on_ms = 0;
+   self->off_ms = 0;
+   self->output_on = false;
+   self->period_us = 0;
+   self->output = 0;
+   self->output_high = 0;
+   self->output_low = 0;
+   self->enabled = false;
+   return;
+}
+
+/********************************************************************************
+* pwm_run: Kör angiven PWM-kontroller under en period och styr ansluten utenhet,
+*          förutsatt att PWM-kontrollern är aktiverad.
+*
+*          - self: Pekare till PWM-kontrollern som ska köras.
+********************************************************************************/
+void pwm_run(struct pwm* self)
+{
+   if (!self->enabled) return;
+   adc_get_pwm_values(&self->input, self->period_us);
+   pwm_run_cycle(self);
+   return;
+}
+
+/********************************************************************************
+* pwm_run_with_duty_cycle: Kör angiven PWM-kontroller under en period och styr
+*                          ansluten utenhet med angiven duty cycle, förutsatt
+*                          att PWM-kontrollern är aktiverad. Duty cycle måste
+*                          anges som ett flyttal mellan 0 - 1, vilket motsvarar
+*                          0 - 100 % duty cycle. Omvandlas till Q0.16-format,
+*                          se pwm_run_with_duty_cycle_q16.
+*
+*         -                - self: Pekare till PWM-kontrollern som ska köras.
+*                          - duty_cycle: Duty cycle, alltså andelen av aktuell
+*                                        periodtid som ansluten utenhet ska
+*                                        vara aktiverad, mellan 0 - 1.
+********************************************************************************/
+void pwm_run_with_duty_cycle(struct pwm* self, 
+                             const double duty_cycle)
+{
+   if (duty_cycle < 0 || duty_cycle > 1) return;
+   pwm_run_with_duty_cycle_q16(self, (uint16_t)(duty_cycle * ADC_Q16_MAX + 0.5));
+   return;
+}
+
+/********************************************************************************
+* pwm_run_with_duty_cycle_q16: Kör angiven PWM-kontroller under en period med
+*                              angiven duty cycle i Q0.16-format, se
+*                              pwm_set_duty_cycle_q16.
+*
+*                              - self    : Pekare till PWM-kontrollern som ska
+*                                          köras.
+*                              - duty_q16: Duty cycle i Q0.16-format.
+********************************************************************************/
+void pwm_run_with_duty_cycle_q16(struct pwm* self,
+                                 const uint16_t duty_q16)
+{
+   if (!self->enabled) return;
+   pwm_set_duty_cycle_q16(self, duty_q16);
+   pwm_run_cycle(self);
+   return;
+}
+
+/********************************************************************************
+* pwm_start: Startar PWM-generering utan blockering med angiven duty cycle i
+*            Q0.16-format. On- och off-tiden beräknas likt vid blockerande
+*            generering och avrundas sedan till hela millisekunder, varefter
+*            utenheten tänds och mjukvarutimern startas med on-tiden.
+*
+*            - self    : Pekare till PWM-kontrollern som ska startas.
+*            - duty_q16: Duty cycle i Q0.16-format.
+********************************************************************************/
+void pwm_start(struct pwm* self,
+               const uint16_t duty_q16)
+{
+   if (!self->enabled) return;
+   soft_timer_stop(&self->timer);
+   pwm_set_duty_cycle_q16(self, duty_q16);
+   self->on_ms = (self->input.pwm_on_us + 500) / 1000;
+   self->off_ms = (self->period_us + 500) / 1000 - self->on_ms;
+
+   if (!self->on_ms)
+   {
+      self->output_on = false;
+      self->output_low(self->output);
+   }
+   else
+   {
+      self->output_on = true;
+      self->output_high(self->output);
+      if (self->off_ms) soft_timer_start(&self->timer, self->on_ms);
+   }
+   return;
+}
+
+/********************************************************************************
+* pwm_stop: Stoppar PWM-generering via pwm_start och släcker utenheten.
+*
+*           - self: Pekare till PWM-kontrollern som ska stoppas.
+********************************************************************************/
+void pwm_stop(struct pwm* self)
+{
+   soft_timer_stop(&self->timer);
+   self->output_on = false;
+   self->output_low(self->output);
+   return;
+}
+
+/********************************************************************************
+* pwm_run_cycle: Kör utenhet ansluten till angiven PWM-kontroller under en 
+*                PWM-period med befintliga PWM-värden.
+*
+*                - self: Pekare till PWM-kontrollern vars anslutna utenhet
+*                        ska köras.
+********************************************************************************/
+static inline void pwm_run_cycle(struct pwm* self)
+{
+   self->output_high(self->output);
+   delay_us(self->input.pwm_on_us);
+   self->output_low(self->output);
+   delay_us(self->input.pwm_off_us);
+   return;
+}
+
+/********************************************************************************
+* pwm_set_duty_cycle_q16: Beräknar on- och off-tid i mikrosekunder för angiven
+*                         duty cycle i Q0.16-format. On-tiden beräknas som
+*                         duty cycle gånger perioden, skiftat 16 steg åt höger.
+*
+*                         - self    : Pekare till PWM-kontrollern.
+*                         - duty_q16: Duty cycle i Q0.16-format.
+********************************************************************************/
+static inline void pwm_set_duty_cycle_q16(struct pwm* self,
+                                          const uint16_t duty_q16)
+{
+   self->input.pwm_on_us = (uint16_t)(((uint32_t)duty_q16 * self->period_us + 0x8000) >> 16);
+   self->input.pwm_off_us = self->period_us - self->input.pwm_on_us;
+   return;
+}
+
+/********************************************************************************
+* pwm_timer_callback: Callbackrutin för PWM-kontrollerns mjukvarutimer, som
+*                     växlar utenheten mellan on- och off-tid och startar om
+*                     timern med nästa tid. Eftersom timern startas om från
+*                     callbackrutinen räknas nästa tid från utgångstiden,
+*                     varför perioden inte driver över tid.
+*
+*                     - arg: Pekare till PWM-kontrollern.
+********************************************************************************/
+static void pwm_timer_callback(void* arg)
+{
+   struct pwm* self = (struct pwm*)arg;
+
+   if (self->output_on)
+   {
+      self->output_on = false;
+      self->output_low(self->output);
+      soft_timer_start(&self->timer, self->off_ms);
+   }
+   else
+   {
+      self->output_on = true;
+      self->output_high(self->output);
+      soft_timer_start(&self->timer, self->on_ms);
+   }
+   return;
 }
\ No newline at end of file
@@ -1,122 +1,173 @@
-/********************************************************************************
-* pwm.h: Innehller drivrutiner fr PWM-styrning av en godtycklig utenhet,
-*        ssom en eller flera lysdioder.
-********************************************************************************/
-#ifndef PWM_H_
-#define PWM_H_
-
-/* Inkluderingsdirektiv: */
-#include "misc.h"
-#include "adc.h"
-
-/********************************************************************************
-* pwm: Strukt fr PWM-kontrollers, som mjliggr PWM-styrning av en godtycklig 
-*      utenhet, exempelvis en eller flera lysdioder implementerat via ett 
-*      led-objekt eller en vektor innehllande pekare till multipla led-objekt. 
-*      PWM-styrning kan ske via en analog insignal ssom en potentiometer eller
-*      genom att direkt vlja duty cycle.
-********************************************************************************/
-struct pwm
-{
-   struct adc input;               /* Analog inenhet, ssom en potentiometer. */
-   uint16_t period_us;             /* Periodtid fr PWM mtt i mikrosekunder. */
-   void* output;                   /* Pekare till ansluten utenhet. */
-   void (*output_high)(void* arg); /* Pekare till funktion fr att tnda ansluten utenhet. */
-   void (*output_low)(void* arg);  /* Pekare till funktion fr att slcka ansluten utenhet. */
-   bool enabled;                   /* Enable-signal fr kontroll av PWM-generering. */
-};
-
-/********************************************************************************
-* pwm_init: Initierar PWM-kontroller fr PWM-styrning av angiven utenhet via
-*           angiven analog insignal. Som default r PWM-styrning aktiverat.
-*
-*           - self       : Pekare till PWM-kontrollern som ska initieras.
-*           - input_pin  : Pekare till analog pin som utgr insignal.
-*           - period_us  : Periodtid fr PWM mtt i mikrosekunder.
-*           - output     : Pekare till utenheten som ska styras med PWM.
-*           - output_high: Funktionspekare fr aktivering av angiven utenhet.
-*           - output_low : Funktionspekare fr inaktivering av angiven utenhet.
-********************************************************************************/
-void pwm_init(struct pwm* self, 
-              uint8_t input_pin,
-              const uint16_t period_us, 
-              void* output,
-              void* output_high, 
-              void* output_low);
-
-/********************************************************************************
-* pwm_clear: Nollstller angiven PWM-kontroller.
-*
-*            - self: Pekare till PWM-kontrollern som ska nollstllas.
-********************************************************************************/
-void pwm_clear(struct pwm* self);
-
-/********************************************************************************
-* pwm_enable: Aktiverar angiven PWM-kontroller s att ansluten utenhet kan
-*             styras via PWM-generering.
-*
-*             - self: Pekare till PWM-kontrollern som ska aktiveras.
-********************************************************************************/
-static inline void pwm_enable(struct pwm* self)
-{
-   self->enabled = true;
-   return;
-}
-
-/********************************************************************************
-* pwm_disable: Inaktiverar angiven PWM-kontroller, vilket medfr att
-*              PWM-styrning av ansluten utenhet inte kan genomfras.
-*
-*
-*              - self: Pekare till PWM-kontrollern som ska inaktiveras.
-********************************************************************************/
-static inline void pwm_disable(struct pwm* self)
-{
-   self->enabled = false;
-   self->output_low(self->output);
-   return;
-}
-
-/********************************************************************************
-* pwm_toggle: Togglar aktivering av angiven PWM-kontroller.
-*
-*
-*              - self: Pekare till PWM-kontrollern som ska togglas.
-********************************************************************************/
-static inline void pwm_toggle(struct pwm* self)
-{
-   if (self->enabled)
-   {
-      pwm_disable(self);
-   }
-   else
-   {
-      pwm_enable(self);
-   }
-   return;
-}
-
-/********************************************************************************
-* pwm_run: Kr angiven PWM-kontroller under en period och styr ansluten utenhet
-*          via avlsning av ansluten analog insignal, frutsatt att 
-*          PWM-kontrollern r aktiverad.
-*
-*          - self: Pekare till PWM-kontrollern som ska kras.
-********************************************************************************/
-void pwm_run(struct pwm* self);
-
-/********************************************************************************
-* pwm_run_with_duty_cycle: Kr angiven PWM-kontroller under en period och styr 
-*                          ansluten utenhet med angiven duty cycle, frutsatt 
-*                          att PWM-kontrollern r aktiverad. Duty cycle mste
-*                          anges som ett flyttal mellan 0 - 1, vilket motsvarar
-*                          0 - 100 % duty cycle.
-*
-*         -                - self: Pekare till PWM-kontrollern som ska kras.
-*                          - duty_cycle: Duty cycle, allts andelen av aktuell
-*                                        periodtid som ansluten utenhet ska
-*                                        vara aktiverad, mellan 0 - 1.
-********************************************************************************/
-void pwm_run_with_duty_cycle(struct pwm* self, const double duty_cycle);
-
+/********************************************************************************
+* pwm.h: Innehåller drivrutiner för PWM-styrning av en godtycklig utenhet,
+*        såsom en eller flera lysdioder.
+*
+*        PWM-generering kan antingen ske blockerande en period i taget via
+*        pwm_run samt pwm_run_with_duty_cycle, där on- och off-tiden väntas
+*        ut med mikrosekundsupplösning, eller utan blockering via pwm_start,
+*        där en mjukvarutimer (se soft_timer.h) växlar utenheten mellan
+*        on- och off-tid. Det senare kräver att timerhjulet drivs från
+*        huvudloopen, exempelvis via task_run, och ger millisekunds-
+*        upplösning, varför periodtiden bör vara minst 10 ms.
+********************************************************************************/
+#ifndef PWM_H_
+#define PWM_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+#include "adc.h"
+#include "soft_timer.h"
+
+/********************************************************************************
+* pwm: Strukt för PWM-kontrollers, som möjliggör PWM-styrning av en godtycklig 
+*      utenhet, exempelvis en eller flera lysdioder implementerat via ett 
+*      led-objekt eller en vektor innehållande pekare till multipla led-objekt. 
+*      PWM-styrning kan ske via en analog insignal såsom en potentiometer eller
+*      genom att direkt välja duty cycle.
+********************************************************************************/
+struct pwm
+{
+   struct adc input;               /* Analog inenhet, såsom en potentiometer. */
+   uint16_t period_us;             /* Periodtid för PWM mätt i mikrosekunder. */
+   void* output;                   /* Pekare till ansluten utenhet. */
+   void (*output_high)(void* arg); /* Pekare till funktion för att tända ansluten utenhet. */
+   void (*output_low)(void* arg);  /* Pekare till funktion för att släcka ansluten utenhet. */
+   struct soft_timer timer;        /* Mjukvarutimer för PWM-generering utan blockering. */
+   uint16_t on_ms;                 /* On-tid vid generering via mjukvarutimern. */
+   uint16_t off_ms;                /* Off-tid vid generering via mjukvarutimern. */
+   bool output_on;                 /* Indikerar ifall utenheten är tänd av mjukvarutimern. */
+   bool enabled;                   /* Enable-signal för kontroll av PWM-generering. */
+};
+
+/********************************************************************************
+* pwm_init: Initierar PWM-kontroller för PWM-styrning av angiven utenhet via
+*           angiven analog insignal. Som default är PWM-styrning aktiverat.
+*
+*           - self       : Pekare till PWM-kontrollern som ska initieras.
+*           - input_pin  : Pekare till analog pin som utgör insignal.
+*           - period_us  : Periodtid för PWM mätt i mikrosekunder.
+*           - output     : Pekare till utenheten som ska styras med PWM.
+*           - output_high: Funktionspekare för aktivering av angiven utenhet.
+*           - output_low : Funktionspekare för inaktivering av angiven utenhet.
+********************************************************************************/
+void pwm_init(struct pwm* self, 
+              uint8_t input_pin,
+              const uint16_t period_us, 
+              void* output,
+              void* output_high, 
+              void* output_low);
+
+/********************************************************************************
+* pwm_clear: Nollställer angiven PWM-kontroller.
+*
+*            - self: Pekare till PWM-kontrollern som ska nollställas.
+********************************************************************************/
+void pwm_clear(struct pwm* self);
+
+/********************************************************************************
+* pwm_enable: Aktiverar angiven PWM-kontroller så att ansluten utenhet kan
+*             styras via PWM-generering.
+*
+*             - self: Pekare till PWM-kontrollern som ska aktiveras.
+********************************************************************************/
+static inline void pwm_enable(struct pwm* self)
+{
+   self->enabled = true;
+   return;
+}
+
+/********************************************************************************
+* pwm_disable: Inaktiverar angiven PWM-kontroller, vilket medför att
+*              PWM-styrning av ansluten utenhet inte kan genomföras.
+*              Pågående generering via pwm_start stoppas.
+*
+*              - self: Pekare till PWM-kontrollern som ska inaktiveras.
+********************************************************************************/
+static inline void pwm_disable(struct pwm* self)
+{
+   self->enabled = false;
+   soft_timer_stop(&self->timer);
+   self->output_on = false;
+   self->output_low(self->output);
+   return;
+}
+
+/********************************************************************************
+* pwm_toggle: Togglar aktivering av angiven PWM-kontroller.
+*
+*
+*              - self: Pekare till PWM-kontrollern som ska togglas.
+********************************************************************************/
+static inline void pwm_toggle(struct pwm* self)
+{
+   if (self->enabled)
+   {
+      pwm_disable(self);
+   }
+   else
+   {
+      pwm_enable(self);
+   }
+   return;
+}
+
+/********************************************************************************
+* pwm_run: Kör angiven PWM-kontroller under en period och styr ansluten utenhet
+*          via avläsning av ansluten analog insignal, förutsatt att 
+*          PWM-kontrollern är aktiverad.
+*
+*          - self: Pekare till PWM-kontrollern som ska köras.
+********************************************************************************/
+void pwm_run(struct pwm* self);
+
+/********************************************************************************
+* pwm_run_with_duty_cycle: Kör angiven PWM-kontroller under en period och styr 
+*                          ansluten utenhet med angiven duty cycle, förutsatt 
+*                          att PWM-kontrollern är aktiverad. Duty cycle måste
+*                          anges som ett flyttal mellan 0 - 1, vilket motsvarar
+*                          0 - 100 % duty cycle.
+*
+*         -                - self: Pekare till PWM-kontrollern som ska köras.
+*                          - duty_cycle: Duty cycle, alltså andelen av aktuell
+*                                        periodtid som ansluten utenhet ska
+*                                        vara aktiverad, mellan 0 - 1.
+********************************************************************************/
+void pwm_run_with_duty_cycle(struct pwm* self, const double duty_cycle);
+
+/********************************************************************************
+* pwm_run_with_duty_cycle_q16: Kör angiven PWM-kontroller under en period och
+*                              styr ansluten utenhet med angiven duty cycle i
+*                              Q0.16-format (0 - 65535, där 65535 motsvarar
+*                              100 %), förutsatt att PWM-kontrollern är
+*                              aktiverad. Beräkningen sker utan flyttal.
+*
+*                              - self    : Pekare till PWM-kontrollern som ska
+*                                          köras.
+*                              - duty_q16: Duty cycle i Q0.16-format.
+********************************************************************************/
+void pwm_run_with_duty_cycle_q16(struct pwm* self,
+                                 const uint16_t duty_q16);
+
+/********************************************************************************
+* pwm_start: Startar PWM-generering utan blockering med angiven duty cycle i
+*            Q0.16-format, förutsatt att PWM-kontrollern är aktiverad.
+*            Utenheten växlas av en mjukvarutimer, där on- och off-tiden
+*            avrundas till hela millisekunder. En avrundad on-tid på 0 ms
+*            släcker utenheten och en off-tid på 0 ms tänder den, varvid
+*            ingen timer behövs. Pågående generering ersätts. Funktionen
+*            får endast anropas från huvudloopen.
+*
+*            - self    : Pekare till PWM-kontrollern som ska startas.
+*            - duty_q16: Duty cycle i Q0.16-format.
+********************************************************************************/
+void pwm_start(struct pwm* self,
+               const uint16_t duty_q16);
+
+/********************************************************************************
+* pwm_stop: Stoppar PWM-generering via pwm_start och släcker utenheten.
+*
+*           - self: Pekare till PWM-kontrollern som ska stoppas.
+********************************************************************************/
+void pwm_stop(struct pwm* self);
+
 #endif /* PWM_H_ */
\ No newline at end of file
@@ -1,119 +1,624 @@
-/********************************************************************************
-* serial.c: Innehller funktionsdefinitioner fr implementering av seriell
-*           verfring via USART.
-********************************************************************************/
-#include "serial.h"
-
-/********************************************************************************
-* serial_init: Initierar USART fr seriell verfring med angiven baud rate,
-*              dr default stts till 9600 kbps (kilobits/sekund). USART 
-*              konfigureras till asynkron verfring med tta bitar i taget,
-*              utan stoppbit.
-*
-*              - baud_rate_kbps: verfringshastigheten, dvs. antalet bitar som 
-'                                transmitteras per sekund (default = 9600 kbps).
-********************************************************************************/
-void serial_init(const uint32_t baud_rate_kbps)
-{
-   static bool serial_initialized = false;
-   if (serial_initialized) return;
-
-   UCSR0B = (1 << TXEN0);
-   UCSR0C = (1 << UCSZ00) | (1 << UCSZ01);
-
-   if (baud_rate_kbps == 0 || baud_rate_kbps == 9600)
-   {
-      UBRR0 = 103;
-   }
-   else
-   {
-      UBRR0 = (uint8_t)(F_CPU / (16.0 * baud_rate_kbps) - 1 + 0.5);  
-   }
-
-   UDR0 = '\r';
-   serial_initialized = true;
-   return;
-}
-
-/********************************************************************************
-* serial_print_string: Skriver ut text via seriell verfring.
-*
-*                      - s: Pekare till det textstycke som ska skrivas ut.
-********************************************************************************/
-void serial_print_string(const char* s)
-{
-   for (const char* i = s; *i; ++i)
-   {
-      serial_print_char(*i);
-
-      if (*i == '\n')
-      {
-         serial_print_char('\r');
-      }
-   }
-   return;
-}
-
-/********************************************************************************
-* serial_print_integer: Skriver ut ett signerat heltal via seriell verfring.
-*
-*                      - number: Heltalet som ska skrivas ut.
-********************************************************************************/
-void serial_print_integer(const int32_t number)
-{
-   char s[20] = { '\0' };
-   sprintf(s, "%ld", number);
-   serial_print_string(s);
-   return;
-}
-
-/********************************************************************************
-* serial_print_unsigned: Skriver ut ett osignerat heltal via seriell verfring.
-*
-*                        - number: Heltalet som ska skrivas ut.
-********************************************************************************/
-void serial_print_unsigned(const uint32_t number)
-{
-   char s[20] = { '\0' };
-   sprintf(s, "%lu", number);
-   serial_print_string(s);
-   return;
-}
-
-/********************************************************************************
-* serial_print_double: Skriver ut ett flyttal med upp till tv decimaler 
-*                      via seriell verfring.
-*
-*                      - number: Flyttalet som ska skrivas ut.
-********************************************************************************/
-void serial_print_double(const double number)
-{
-   const int32_t integer = (int32_t)number;
-   int32_t decimal;
-   char s[20] = { '\0' };
-   
-   if (integer >= 0)
-   {
-      decimal = (int32_t)((number - integer) * 100 + 0.5);
-   }
-   else
-   {
-      decimal = (int32_t)((integer - number) * 100 + 0.5);
-   }
-
-   sprintf(s, "%ld.%ld", integer, decimal);
-   serial_print_string(s);
-   return;
-}
-
-/********************************************************************************
-* serial_print_char: Skriver ut ett enskilt tecken via seriell verfring.
-*
-*                    - character: Det tecken som ska skrivas ut.
-********************************************************************************/
-void serial_print_char(const char character)
-{
-   while ((UCSR0A & (1 << UDRE0)) == 0);
-   UDR0 = character;
-   return;
+/********************************************************************************
+* serial.c: Innehåller funktionsdefinitioner för implementering av seriell
+*           överföring via USART.
+********************************************************************************/
+#include "serial.h"
+#include "isr_probe.h"
+
+/* Makrodefinitioner: */
+#define SERIAL_TX_BUFFER_MASK (SERIAL_TX_BUFFER_SIZE - 1) /* Bitmask för index i sändbufferten. */
+#define SERIAL_RX_BUFFER_MASK (SERIAL_RX_BUFFER_SIZE - 1) /* Bitmask för index i mottagarbufferten. */
+#define SERIAL_DIGITS_MAX 10 /* Maximalt antal siffror i ett osignerat 32-bitars heltal. */
+#define SERIAL_UBRR_MAX 4095 /* Högsta värde för UBRR0 (12 bitar). */
+
+/* Statiska variabler: */
+static volatile char tx_buffer[SERIAL_TX_BUFFER_SIZE]; /* Ringbuffert för utskrift. */
+static volatile uint8_t tx_head = 0; /* Index där nästa tecken lagras. */
+static volatile uint8_t tx_tail = 0; /* Index för nästa tecken att skicka. */
+static enum serial_overflow_policy overflow_policy = SERIAL_OVERFLOW_BLOCK; /* Policy vid full buffert. */
+static struct serial_tx_stats tx_stats; /* Statistik för sändbufferten. */
+static volatile char rx_buffer[SERIAL_RX_BUFFER_SIZE]; /* Ringbuffert för mottagna tecken. */
+static volatile uint8_t rx_head = 0;      /* Index där nästa mottagna tecken lagras. */
+static volatile uint8_t rx_tail = 0;      /* Index för äldsta ohämtade tecken. */
+static volatile uint16_t rx_overruns = 0; /* Antal förlorade mottagna tecken. */
+static struct serial_baud selected_baud;  /* Vald baud rate. */
+
+/* Tiopotenser för framtagning av siffror via subtraktion (lagras i programminnet): */
+static const uint32_t powers_of_ten32[] PROGMEM = { 1000000000, 100000000, 10000000, 1000000, 100000, 10000 };
+static const uint16_t powers_of_ten16[] PROGMEM = { 10000, 1000, 100, 10 };
+
+/* Statiska funktioner: */
+static void serial_select_baud(const uint32_t baud_rate);
+static uint16_t serial_compute_ubrr(const uint32_t baud_rate,
+                                    const uint8_t divisor,
+                                    uint32_t* achieved);
+static void serial_transmit_oldest(void);
+static inline void serial_write_data(const char character);
+
+/********************************************************************************
+* serial_init: Initierar USART för seriell överföring med angiven baud rate,
+*              där default sätts till 9600 baud. USART konfigureras till
+*              asynkron överföring med åtta bitar i taget, utan paritet och
+*              med en stoppbit. Både sändare och mottagare aktiveras, där
+*              avbrott aktiveras för mottagna tecken. Baud rate väljs via
+*              serial_select_baud, som jämför normal och dubbel hastighet.
+*
+*              - baud_rate: Överföringshastigheten, dvs. antalet bitar som 
+*                           transmitteras per sekund (default = 9600).
+********************************************************************************/
+void serial_init(const uint32_t baud_rate)
+{
+   static bool serial_initialized = false;
+   if (serial_initialized) return;
+
+   serial_select_baud(baud_rate ? baud_rate : 9600);
+
+   UCSR0A = selected_baud.double_speed ? (1 << U2X0) : 0;
+   UBRR0 = selected_baud.ubrr;
+   UCSR0B = (1 << TXEN0) | (1 << RXEN0) | (1 << RXCIE0);
+   UCSR0C = (1 << UCSZ00) | (1 << UCSZ01);
+
+   serial_write_data('\r');
+   serial_initialized = true;
+   return;
+}
+
+/********************************************************************************
+* serial_get_baud: Läser av begärd samt faktisk baud rate, avvikelse, UBRR0
+*                  samt ifall dubbel hastighet används.
+*
+*                  - baud: Pekare till strukt där informationen lagras.
+********************************************************************************/
+void serial_get_baud(struct serial_baud* baud)
+{
+   *baud = selected_baud;
+   return;
+}
+
+/********************************************************************************
+* serial_set_overflow_policy: Väljer hur utskrift hanteras när sändbufferten
+*                             är full.
+*
+*                             - policy: Policy för full sändbuffert.
+********************************************************************************/
+void serial_set_overflow_policy(const enum serial_overflow_policy policy)
+{
+   overflow_policy = policy;
+   return;
+}
+
+/********************************************************************************
+* serial_get_tx_stats: Läser av statistiken för sändbufferten med avbrott
+*                      tillfälligt inaktiverade, eftersom räknarna är 32 bitar.
+*
+*                      - stats: Pekare till strukt där statistiken lagras.
+********************************************************************************/
+void serial_get_tx_stats(struct serial_tx_stats* stats)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   *stats = tx_stats;
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* serial_reset_tx_stats: Nollställer statistiken för sändbufferten.
+********************************************************************************/
+void serial_reset_tx_stats(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   tx_stats.queued = 0;
+   tx_stats.dropped = 0;
+   tx_stats.peak = 0;
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* serial_tx_pending: Returnerar antalet tecken som väntar i sändbufferten.
+*                    Indexen är 8 bitar och läses därmed i en instruktion.
+********************************************************************************/
+uint8_t serial_tx_pending(void)
+{
+   return (uint8_t)(tx_head - tx_tail) & SERIAL_TX_BUFFER_MASK;
+}
+
+/********************************************************************************
+* serial_flush: Väntar tills samtliga tecken i sändbufferten har skickats.
+*               Ifall avbrott är inaktiverade töms bufferten via pollning.
+*               Därefter väntar funktionen tills sista tecknet har skiftats
+*               ut (TXC0 ettställd), eftersom ett tecken som skiftas ut när
+*               USART stängs av i sleep mode annars blir korrupt.
+********************************************************************************/
+void serial_flush(void)
+{
+   while (serial_tx_pending())
+   {
+      if (!(SREG & (1 << SREG_I)))
+      {
+         serial_transmit_oldest();
+      }
+   }
+
+   if (UCSR0B & (1 << TXEN0))
+   {
+      while ((UCSR0A & (1 << TXC0)) == 0);
+   }
+   return;
+}
+
+/********************************************************************************
+* serial_read_char: Hämtar äldsta mottagna tecken ur mottagarbufferten. Endast
+*                   avbrottsrutinen skriver till head och endast denna
+*                   funktion skriver till tail, varför avbrott inte behöver
+*                   inaktiveras.
+*
+*                   - character: Pekare till variabel där tecknet lagras.
+********************************************************************************/
+bool serial_read_char(char* character)
+{
+   const uint8_t index = rx_tail;
+
+   if (index == rx_head) return false;
+
+   *character = rx_buffer[index];
+   rx_tail = (index + 1) & SERIAL_RX_BUFFER_MASK;
+   return true;
+}
+
+/********************************************************************************
+* serial_rx_available: Indikerar ifall det finns mottagna tecken i
+*                      mottagarbufferten.
+********************************************************************************/
+bool serial_rx_available(void)
+{
+   return rx_head != rx_tail;
+}
+
+/********************************************************************************
+* serial_rx_overruns: Returnerar antalet mottagna tecken som har förlorats på
+*                     grund av att mottagarbufferten var full.
+********************************************************************************/
+uint16_t serial_rx_overruns(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint16_t num_overruns = rx_overruns;
+   SREG = sreg;
+   return num_overruns;
+}
+
+/********************************************************************************
+* serial_print_string: Skriver ut text via seriell överföring.
+*
+*                      - s: Pekare till det textstycke som ska skrivas ut.
+********************************************************************************/
+void serial_print_string(const char* s)
+{
+   for (const char* i = s; *i; ++i)
+   {
+      serial_print_char(*i);
+
+      if (*i == '\n')
+      {
+         serial_print_char('\r');
+      }
+   }
+   return;
+}
+
+/********************************************************************************
+* serial_print_string_P: Skriver ut text lagrad i programminnet via seriell
+*                        överföring. Radbrytningar hanteras som i
+*                        serial_print_string.
+*
+*                        - s: Pekare till textstycket i programminnet.
+********************************************************************************/
+void serial_print_string_P(PGM_P s)
+{
+   char c;
+
+   while ((c = (char)pgm_read_byte(s++)))
+   {
+      serial_print_char(c);
+
+      if (c == '\n')
+      {
+         serial_print_char('\r');
+      }
+   }
+   return;
+}
+
+/********************************************************************************
+* serial_print_integer: Skriver ut ett signerat 32-bitars heltal via seriell
+*                       överföring. Beloppet beräknas som osignerat tal, så
+*                       att även INT32_MIN skrivs ut korrekt.
+*
+*                       - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_integer(const int32_t number)
+{
+   if (number < 0)
+   {
+      serial_print_char('-');
+      serial_print_unsigned(0UL - (uint32_t)number);
+   }
+   else
+   {
+      serial_print_unsigned((uint32_t)number);
+   }
+   return;
+}
+
+/********************************************************************************
+* serial_print_unsigned: Skriver ut ett osignerat 32-bitars heltal via seriell
+*                        överföring.
+*
+*                        - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_unsigned(const uint32_t number)
+{
+   char s[SERIAL_DIGITS_MAX + 1];
+   serial_format_unsigned(number, s);
+   serial_print_string(s);
+   return;
+}
+
+/********************************************************************************
+* serial_print_int16: Skriver ut ett signerat 16-bitars heltal via seriell
+*                     överföring.
+*
+*                     - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_int16(const int16_t number)
+{
+   if (number < 0)
+   {
+      serial_print_char('-');
+      serial_print_uint16(0U - (uint16_t)number);
+   }
+   else
+   {
+      serial_print_uint16((uint16_t)number);
+   }
+   return;
+}
+
+/********************************************************************************
+* serial_print_uint16: Skriver ut ett osignerat 16-bitars heltal via seriell
+*                      överföring.
+*
+*                      - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_uint16(const uint16_t number)
+{
+   char s[SERIAL_DIGITS_MAX + 1];
+   serial_format_unsigned(number, s);
+   serial_print_string(s);
+   return;
+}
+
+/********************************************************************************
+* serial_print_fixed: Skriver ut ett fixpunktstal via seriell överföring, där
+*                     angivet heltal utgör talet multiplicerat med 10 upphöjt
+*                     till antalet decimaler. Exempelvis skrivs värdet -5 med
+*                     två decimaler ut som -0.05. Siffrorna tas fram utan
+*                     division, varefter decimalpunkten sätts in och
+*                     eventuella nollor fylls på framför.
+*
+*                     - value   : Talet multiplicerat med 10^decimals.
+*                     - decimals: Antalet decimaler (0 - 9).
+********************************************************************************/
+void serial_print_fixed(const int32_t value,
+                        uint8_t decimals)
+{
+   char s[SERIAL_DIGITS_MAX + 1];
+   const uint32_t magnitude = value < 0 ? 0UL - (uint32_t)value : (uint32_t)value;
+   const uint8_t length = serial_format_unsigned(magnitude, s);
+
+   if (decimals > SERIAL_DIGITS_MAX - 1) decimals = SERIAL_DIGITS_MAX - 1;
+   if (value < 0) serial_print_char('-');
+
+   if (length <= decimals)
+   {
+      serial_print_char('0');
+   }
+   else
+   {
+      for (uint8_t i = 0; i < length - decimals; ++i)
+      {
+         serial_print_char(s[i]);
+      }
+   }
+
+   if (!decimals) return;
+   serial_print_char('.');
+
+   for (uint8_t i = length; i < decimals; ++i)
+   {
+      serial_print_char('0');
+   }
+
+   serial_print_string(length <= decimals ? s : s + length - decimals);
+   return;
+}
+
+/********************************************************************************
+* serial_print_double: Skriver ut ett flyttal avrundat till två decimaler via
+*                      seriell överföring. Talet omvandlas till ett
+*                      fixpunktstal med två decimaler, avrundat bort från noll,
+*                      vilket gör att även tal mellan -1 och 0 samt decimaler
+*                      under 0.10 skrivs ut korrekt. Tal vars belopp överstiger
+*                      cirka 21 miljoner kan inte skrivas ut.
+*
+*                      - number: Flyttalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_double(const double number)
+{
+   const double scaled = number * 100;
+   serial_print_fixed((int32_t)(scaled < 0 ? scaled - 0.5 : scaled + 0.5), 2);
+   return;
+}
+
+/********************************************************************************
+* serial_print_char: Lägger ett enskilt tecken sist i sändbufferten, följt av
+*                    att avbrott aktiveras för tomt dataregister, så att
+*                    tecknet skickas i avbrottsrutinen.
+*
+*                    Köoperationen sker med avbrott tillfälligt inaktiverade,
+*                    så att tecken kan läggas i bufferten både från
+*                    huvudloopen och från avbrottsrutiner. Ifall bufferten är
+*                    full hanteras tecknet enligt vald policy. Vid blockering
+*                    aktiveras avbrott mellan varje försök, så att
+*                    avbrottsrutinen kan tömma bufferten. Anropas funktionen
+*                    med avbrott inaktiverade skickas i stället äldsta tecken
+*                    via pollning.
+*
+*                    - character: Det tecken som ska skrivas ut.
+********************************************************************************/
+void serial_print_char(const char character)
+{
+   while (1)
+   {
+      const uint8_t sreg = SREG;
+      asm("CLI");
+      const uint8_t next = (tx_head + 1) & SERIAL_TX_BUFFER_MASK;
+
+      if (next != tx_tail)
+      {
+         tx_buffer[tx_head] = character;
+         tx_head = next;
+         tx_stats.queued++;
+
+         const uint8_t pending = serial_tx_pending();
+         if (pending > tx_stats.peak) tx_stats.peak = pending;
+
+         UCSR0B |= (1 << UDRIE0);
+         SREG = sreg;
+         return;
+      }
+
+      if (overflow_policy == SERIAL_OVERFLOW_DROP)
+      {
+         tx_stats.dropped++;
+         SREG = sreg;
+         return;
+      }
+      else if (overflow_policy == SERIAL_OVERFLOW_OVERWRITE)
+      {
+         tx_tail = (tx_tail + 1) & SERIAL_TX_BUFFER_MASK;
+         tx_stats.dropped++;
+      }
+      else if (!(sreg & (1 << SREG_I)))
+      {
+         serial_transmit_oldest();
+      }
+
+      SREG = sreg;
+   }
+}
+
+/********************************************************************************
+* serial_select_baud: Beräknar UBRR0 för både normal hastighet (divisor 16)
+*                     och dubbel hastighet (divisor 8) och väljer läget med
+*                     minst avvikelse från begärd baud rate. Beräkningen sker
+*                     med heltal, där avvikelsen anges i hundradels procent.
+*
+*                     - baud_rate: Begärd baud rate i bitar per sekund.
+********************************************************************************/
+static void serial_select_baud(const uint32_t baud_rate)
+{
+   uint32_t normal, doubled;
+   const uint16_t ubrr_normal = serial_compute_ubrr(baud_rate, 16, &normal);
+   const uint16_t ubrr_doubled = serial_compute_ubrr(baud_rate, 8, &doubled);
+   const uint32_t error_normal = normal > baud_rate ? normal - baud_rate : baud_rate - normal;
+   const uint32_t error_doubled = doubled > baud_rate ? doubled - baud_rate : baud_rate - doubled;
+
+   selected_baud.requested = baud_rate;
+   selected_baud.double_speed = error_doubled < error_normal;
+   selected_baud.ubrr = selected_baud.double_speed ? ubrr_doubled : ubrr_normal;
+   selected_baud.achieved = selected_baud.double_speed ? doubled : normal;
+
+   const uint32_t error = selected_baud.double_speed ? error_doubled : error_normal;
+   uint32_t error_x100 = error <= UINT32_MAX / 10000 ?
+      (error * 10000 + baud_rate / 2) / baud_rate : error / (baud_rate / 10000);
+
+   if (error_x100 > INT16_MAX) error_x100 = INT16_MAX;
+   selected_baud.error_x100 = selected_baud.achieved >= baud_rate ? (int16_t)error_x100 : -(int16_t)error_x100;
+   return;
+}
+
+/********************************************************************************
+* serial_compute_ubrr: Beräknar avrundat värde för UBRR0 för angiven divisor
+*                      enligt UBRR0 = F_CPU / (divisor * baud rate) - 1,
+*                      begränsat till 0 - 4095, samt motsvarande faktiska
+*                      baud rate.
+*
+*                      - baud_rate: Begärd baud rate i bitar per sekund.
+*                      - divisor  : 16 vid normal hastighet, 8 vid dubbel.
+*                      - achieved : Pekare till variabel för faktisk baud rate.
+********************************************************************************/
+static uint16_t serial_compute_ubrr(const uint32_t baud_rate,
+                                    const uint8_t divisor,
+                                    uint32_t* achieved)
+{
+   const uint32_t denominator = (uint32_t)divisor * baud_rate;
+   uint32_t ubrr = (F_CPU + denominator / 2) / denominator;
+
+   if (ubrr) ubrr--;
+   if (ubrr > SERIAL_UBRR_MAX) ubrr = SERIAL_UBRR_MAX;
+
+   *achieved = F_CPU / ((uint32_t)divisor * (ubrr + 1));
+   return (uint16_t)ubrr;
+}
+
+/********************************************************************************
+* serial_transmit_oldest: Skickar äldsta tecken i sändbufferten via pollning.
+*                         Används när bufferten behöver tömmas medan avbrott
+*                         är inaktiverade.
+********************************************************************************/
+static void serial_transmit_oldest(void)
+{
+   while ((UCSR0A & (1 << UDRE0)) == 0);
+   serial_write_data(tx_buffer[tx_tail]);
+   tx_tail = (tx_tail + 1) & SERIAL_TX_BUFFER_MASK;
+   return;
+}
+
+/********************************************************************************
+* serial_format_unsigned: Omvandlar ett osignerat heltal till text utan
+*                         division, som på AVR saknar hårdvarustöd och kostar
+*                         flera hundra klockcykler per 32-bitars division.
+*                         Varje siffra tas i stället fram genom att motsvarande
+*                         tiopotens subtraheras så många gånger som möjligt,
+*                         vilket kräver högst nio subtraktioner per siffra.
+*                         Tal som inte ryms i 16 bitar får sina sex högsta
+*                         siffror framtagna med 32-bitars aritmetik, varefter
+*                         resterande värde (under 10 000) ryms i 16 bitar, där
+*                         aritmetiken är ungefär dubbelt så snabb. Mindre tal
+*                         hanteras helt med 16-bitars aritmetik. Inledande
+*                         nollor skrivs inte ut.
+*
+*                         Returnerar antalet siffror, där texten avslutas med
+*                         ett nolltecken.
+*
+*                         - number: Heltalet som ska omvandlas.
+*                         - s     : Pekare till buffert om minst 11 tecken.
+********************************************************************************/
+uint8_t serial_format_unsigned(uint32_t number,
+                               char* s)
+{
+   uint8_t length = 0;
+   uint8_t start = 0;
+
+   if (number > UINT16_MAX)
+   {
+      start = 1;
+
+      for (uint8_t i = 0; i < 6; ++i)
+      {
+         const uint32_t power = pgm_read_dword(&powers_of_ten32[i]);
+         char digit = '0';
+
+         while (number >= power)
+         {
+            number -= power;
+            digit++;
+         }
+
+         if (digit != '0' || length) s[length++] = digit;
+      }
+   }
+
+   uint16_t rest = (uint16_t)number;
+
+   for (uint8_t i = start; i < 4; ++i)
+   {
+      const uint16_t power = pgm_read_word(&powers_of_ten16[i]);
+      char digit = '0';
+
+      while (rest >= power)
+      {
+         rest -= power;
+         digit++;
+      }
+
+      if (digit != '0' || length) s[length++] = digit;
+   }
+
+   s[length++] = '0' + rest;
+   s[length] = '\0';
+   return length;
+}
+
+/********************************************************************************
+* serial_write_data: Skriver ett tecken till sändarens dataregister. TXC0
+*                    nollställs först (genom att ettställas), så att flaggan
+*                    indikerar att just detta tecken har skiftats ut, se
+*                    serial_flush. U2X0 samt MPCM0 behålls, övriga flaggor
+*                    skrivs som noll enligt databladet.
+*
+*                    - character: Tecknet som ska skickas.
+********************************************************************************/
+static inline void serial_write_data(const char character)
+{
+   UCSR0A = (UCSR0A & ((1 << U2X0) | (1 << MPCM0))) | (1 << TXC0);
+   UDR0 = character;
+   return;
+}
+
+/********************************************************************************
+* ISR (USART_UDRE_vect): Avbrottsrutin som äger rum när sändarens dataregister
+*                        är tomt. Nästa tecken i sändbufferten skickas. När
+*                        bufferten är tom inaktiveras avbrottet, som annars
+*                        skulle fortsätta att utlösas.
+********************************************************************************/
+ISR (USART_UDRE_vect)
+{
+   ISR_PROBE_ENTER(ISR_PROBE_NO_LATENCY);
+   const uint8_t index = tx_tail;
+
+   if (index == tx_head)
+   {
+      UCSR0B &= ~(1 << UDRIE0);
+   }
+   else
+   {
+      serial_write_data(tx_buffer[index]);
+      tx_tail = (index + 1) & SERIAL_TX_BUFFER_MASK;
+   }
+   ISR_PROBE_EXIT(ISR_PROBE_USART_UDRE);
+   return;
+}
+
+/********************************************************************************
+* ISR (USART_RX_vect): Avbrottsrutin som äger rum när ett tecken har mottagits.
+*                      Tecknet läses alltid ut ur dataregistret, vilket
+*                      nollställer avbrottsflaggan, och lagras sedan i
+*                      mottagarbufferten. Ifall bufferten är full slängs
+*                      tecknet och räknas som förlorat. Avbrottsrutinen
+*                      innehåller inga loopar och tar därmed alltid lika lång
+*                      tid, oavsett hur snabbt tecken tas emot.
+********************************************************************************/
+ISR (USART_RX_vect)
+{
+   ISR_PROBE_ENTER(ISR_PROBE_NO_LATENCY);
+   const char character = UDR0;
+   const uint8_t index = rx_head;
+   const uint8_t next = (index + 1) & SERIAL_RX_BUFFER_MASK;
+
+   if (next == rx_tail)
+   {
+      rx_overruns++;
+   }
+   else
+   {
+      rx_buffer[index] = character;
+      rx_head = next;
+   }
+   ISR_PROBE_EXIT(ISR_PROBE_USART_RX);
+   return;
 }
\ No newline at end of file
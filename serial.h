@@ -1,62 +1,287 @@
-/********************************************************************************
-* serial.h: Innehller drivrutiner fr seriell verfring via USART.
-********************************************************************************/
-#ifndef SERIAL_H_
-#define SERIAL_H_
-
-/* Inkluderingsdirektiv: */
-#include "misc.h"
-
-/********************************************************************************
-* serial_init: Initierar USART fr seriell verfring med angiven baud rate.
-*
-*              - baud_rate: verfringshastighet mtt i kilobits per sekund.
-********************************************************************************/
-void serial_init(const uint32_t baud_rate_kbps);
-
-/********************************************************************************
-* serial_print_string: Skriver ut text via seriell verfring.
-*
-*                      - s: Pekare till det textstycke som ska skrivas ut.
-********************************************************************************/
-void serial_print_string(const char* s);
-
-/********************************************************************************
-* serial_print_integer: Skriver ut ett signerat heltal via seriell verfring.
-*
-*                      - number: Heltalet som ska skrivas ut.
-********************************************************************************/
-void serial_print_integer(const int32_t number);
-
-/********************************************************************************
-* serial_print_unsigned: Skriver ut ett osignerat heltal via seriell verfring.
-*
-*                        - number: Heltalet som ska skrivas ut.
-********************************************************************************/
-void serial_print_unsigned(const uint32_t number);
-
-/********************************************************************************
-* serial_print_double: Skriver ut ett flyttal via seriell verfring.
-*
-*                      - number: Flyttalet som ska skrivas ut.
-********************************************************************************/
-void serial_print_double(const double number);
-
-/********************************************************************************
-* serial_print_char: Skriver ut ett enskilt tecken via seriell verfring.
-*
-*                    - character: Det tecken som ska skrivas ut.
-********************************************************************************/
-void serial_print_char(const char character);
-
-/********************************************************************************
-* serial_print_new_line: Stter nsta utskrift till lngst till vnster p 
-*                        nsta rad via utskrift av ett nyradstecken.
-********************************************************************************/
-static inline void serial_print_new_line(void)
-{
-   serial_print_string("\n");
-   return;
-}
-
+/********************************************************************************
+* serial.h: Innehåller drivrutiner för seriell överföring via USART.
+*
+*           Utskrift sker via en ringbuffert, som töms i avbrottsrutinen för
+*           vektorn USART_UDRE_vect en byte i taget när sändarens dataregister
+*           är tomt. Utskriftsfunktionerna lägger därmed endast tecken i
+*           bufferten och returnerar direkt så länge bufferten har plats.
+*           Vad som sker när bufferten är full bestäms av vald policy, se
+*           serial_set_overflow_policy.
+*
+*           Mottagna tecken lagras i en separat ringbuffert i avbrottsrutinen
+*           för vektorn USART_RX_vect, som endast kopierar tecknet och därmed
+*           tar ett begränsat antal klockcykler oavsett datatakt. Tolkning av
+*           mottagna tecken sker i huvudloopen, exempelvis via shell.h.
+********************************************************************************/
+#ifndef SERIAL_H_
+#define SERIAL_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+#include <avr/pgmspace.h>
+
+/* Makrodefinitioner: */
+#ifndef SERIAL_TX_BUFFER_SIZE
+#define SERIAL_TX_BUFFER_SIZE 64 /* Storlek på sändbufferten (tvåpotens, max 256). */
+#endif
+
+#ifndef SERIAL_RX_BUFFER_SIZE
+#define SERIAL_RX_BUFFER_SIZE 32 /* Storlek på mottagarbufferten (tvåpotens, max 256). */
+#endif
+
+/********************************************************************************
+* serial_overflow_policy: Enumeration för val av hantering av utskrift när
+*                         sändbufferten är full.
+********************************************************************************/
+enum serial_overflow_policy
+{
+   SERIAL_OVERFLOW_BLOCK,    /* Vänta tills plats finns (default). */
+   SERIAL_OVERFLOW_DROP,     /* Släng nya tecken. */
+   SERIAL_OVERFLOW_OVERWRITE /* Skriv över äldsta tecken i bufferten. */
+};
+
+/********************************************************************************
+* serial_tx_stats: Strukt för lagring av statistik för sändbufferten.
+********************************************************************************/
+struct serial_tx_stats
+{
+   uint32_t queued;  /* Antal tecken som har lagts i bufferten. */
+   uint32_t dropped; /* Antal tecken som har slängts eller skrivits över. */
+   uint8_t peak;     /* Högsta antal tecken som samtidigt har legat i bufferten. */
+};
+
+/********************************************************************************
+* serial_baud: Strukt för lagring av vald baud rate, se serial_get_baud.
+********************************************************************************/
+struct serial_baud
+{
+   uint32_t requested;  /* Begärd baud rate. */
+   uint32_t achieved;   /* Faktisk baud rate, dvs. F_CPU / (divisor * (UBRR0 + 1)). */
+   int16_t error_x100;  /* Avvikelse från begärd baud rate i hundradels procent. */
+   uint16_t ubrr;       /* Värde lagrat i UBRR0 (0 - 4095). */
+   bool double_speed;   /* Indikerar ifall U2X0 används (divisor 8 i stället för 16). */
+};
+
+/********************************************************************************
+* serial_init: Initierar USART för seriell överföring med angiven baud rate.
+*              Både normal hastighet (divisor 16) och dubbel hastighet via
+*              U2X0 (divisor 8) beräknas, där läget med minst avvikelse från
+*              begärd baud rate väljs. Vid lika avvikelse väljs normal
+*              hastighet, som har bättre tolerans mot klockavvikelser hos
+*              mottagaren. Vid 16 MHz ger exempelvis 250 000, 500 000 samt
+*              1 000 000 baud ingen avvikelse, medan 115 200 baud ger en
+*              avvikelse på 2,1 % via U2X0 (mot -3,5 % utan).
+*
+*              - baud_rate: Överföringshastighet i bitar per sekund
+*                           (0 = default 9600).
+********************************************************************************/
+void serial_init(const uint32_t baud_rate);
+
+/********************************************************************************
+* serial_get_baud: Läser av begärd samt faktisk baud rate, avvikelse, UBRR0
+*                  samt ifall dubbel hastighet används. En avvikelse över
+*                  cirka ±2 % riskerar felaktig överföring.
+*
+*                  - baud: Pekare till strukt där informationen lagras.
+********************************************************************************/
+void serial_get_baud(struct serial_baud* baud);
+
+/********************************************************************************
+* serial_set_overflow_policy: Väljer hur utskrift hanteras när sändbufferten
+*                             är full. Med SERIAL_OVERFLOW_BLOCK väntar
+*                             utskriften tills plats finns, vilket garanterar
+*                             att inga tecken går förlorade. Sker utskriften
+*                             med avbrott inaktiverade (exempelvis från en
+*                             avbrottsrutin) skickas äldsta tecken direkt via
+*                             pollning för att frigöra plats. Med
+*                             SERIAL_OVERFLOW_DROP samt
+*                             SERIAL_OVERFLOW_OVERWRITE blockerar utskrift
+*                             aldrig, men tecken kan gå förlorade.
+*
+*                             - policy: Policy för full sändbuffert.
+********************************************************************************/
+void serial_set_overflow_policy(const enum serial_overflow_policy policy);
+
+/********************************************************************************
+* serial_get_tx_stats: Läser av statistiken för sändbufferten.
+*
+*                      - stats: Pekare till strukt där statistiken lagras.
+********************************************************************************/
+void serial_get_tx_stats(struct serial_tx_stats* stats);
+
+/********************************************************************************
+* serial_reset_tx_stats: Nollställer statistiken för sändbufferten.
+********************************************************************************/
+void serial_reset_tx_stats(void);
+
+/********************************************************************************
+* serial_tx_pending: Returnerar antalet tecken som väntar i sändbufferten.
+********************************************************************************/
+uint8_t serial_tx_pending(void);
+
+/********************************************************************************
+* serial_flush: Väntar tills samtliga tecken i sändbufferten har skickats
+*               och sista tecknet har skiftats ut, exempelvis inför sleep
+*               mode där USART stängs av eller inför återställning av systemet.
+********************************************************************************/
+void serial_flush(void);
+
+/********************************************************************************
+* serial_read_char: Hämtar äldsta mottagna tecken ur mottagarbufferten. Ifall
+*                   bufferten är tom returneras false, annars true.
+*
+*                   - character: Pekare till variabel där tecknet lagras.
+********************************************************************************/
+bool serial_read_char(char* character);
+
+/********************************************************************************
+* serial_rx_available: Indikerar ifall det finns mottagna tecken i
+*                      mottagarbufferten.
+********************************************************************************/
+bool serial_rx_available(void);
+
+/********************************************************************************
+* serial_rx_overruns: Returnerar antalet mottagna tecken som har förlorats på
+*                     grund av att mottagarbufferten var full.
+********************************************************************************/
+uint16_t serial_rx_overruns(void);
+
+/********************************************************************************
+* serial_print_string: Skriver ut text via seriell överföring.
+*
+*                      - s: Pekare till det textstycke som ska skrivas ut.
+********************************************************************************/
+void serial_print_string(const char* s);
+
+/********************************************************************************
+* serial_print_string_P: Skriver ut text lagrad i programminnet via seriell
+*                        överföring. Texten läses en byte i taget via
+*                        instruktionen lpm och kopieras därmed aldrig till
+*                        RAM, till skillnad från textlitteraler som skickas
+*                        till serial_print_string, vilka kopieras från flash
+*                        till RAM vid uppstart och ligger kvar där.
+*
+*                        - s: Pekare till textstycket i programminnet.
+********************************************************************************/
+void serial_print_string_P(PGM_P s);
+
+/********************************************************************************
+* SERIAL_PRINT_P: Skriver ut en textlitteral som endast lagras i programminnet,
+*                 exempelvis SERIAL_PRINT_P("Temperature: "). Makrot kan
+*                 endast användas inuti funktioner (se PSTR i avr-libc).
+********************************************************************************/
+#define SERIAL_PRINT_P(s) serial_print_string_P(PSTR(s))
+
+/********************************************************************************
+* serial_print_integer: Skriver ut ett signerat 32-bitars heltal via seriell
+*                       överföring.
+*
+*                       - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_integer(const int32_t number);
+
+/********************************************************************************
+* serial_print_unsigned: Skriver ut ett osignerat 32-bitars heltal via seriell
+*                        överföring.
+*
+*                        - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_unsigned(const uint32_t number);
+
+/********************************************************************************
+* serial_print_int16: Skriver ut ett signerat 16-bitars heltal via seriell
+*                     överföring, vilket går snabbare än serial_print_integer.
+*
+*                     - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_int16(const int16_t number);
+
+/********************************************************************************
+* serial_print_uint16: Skriver ut ett osignerat 16-bitars heltal via seriell
+*                      överföring, vilket går snabbare än serial_print_unsigned.
+*
+*                      - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_uint16(const uint16_t number);
+
+/********************************************************************************
+* serial_print_int8: Skriver ut ett signerat 8-bitars heltal via seriell
+*                    överföring.
+*
+*                    - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+static inline void serial_print_int8(const int8_t number)
+{
+   serial_print_int16(number);
+   return;
+}
+
+/********************************************************************************
+* serial_print_uint8: Skriver ut ett osignerat 8-bitars heltal via seriell
+*                     överföring.
+*
+*                     - number: Heltalet som ska skrivas ut.
+********************************************************************************/
+static inline void serial_print_uint8(const uint8_t number)
+{
+   serial_print_uint16(number);
+   return;
+}
+
+/********************************************************************************
+* serial_print_fixed: Skriver ut ett fixpunktstal via seriell överföring, där
+*                     angivet heltal utgör talet multiplicerat med 10 upphöjt
+*                     till antalet decimaler. Exempelvis skrivs temperaturen
+*                     23.45 grader lagrad som 2345 ut via anropet
+*                     serial_print_fixed(2345, 2).
+*
+*                     - value   : Talet multiplicerat med 10^decimals.
+*                     - decimals: Antalet decimaler (0 - 9).
+********************************************************************************/
+void serial_print_fixed(const int32_t value,
+                        uint8_t decimals);
+
+/********************************************************************************
+* serial_format_unsigned: Omvandlar ett osignerat heltal till text utan
+*                         division, se serial_print_unsigned. Inledande
+*                         nollor skrivs inte ut. Används internt av
+*                         utskriftsfunktionerna, men kan även anropas direkt,
+*                         exempelvis för att mäta formateringen separat från
+*                         själva överföringen.
+*
+*                         Returnerar antalet siffror, där texten avslutas med
+*                         ett nolltecken.
+*
+*                         - number: Heltalet som ska omvandlas.
+*                         - s     : Pekare till buffert om minst 11 tecken.
+********************************************************************************/
+uint8_t serial_format_unsigned(uint32_t number,
+                               char* s);
+
+/********************************************************************************
+* serial_print_double: Skriver ut ett flyttal avrundat till två decimaler via
+*                      seriell överföring.
+*
+*                      - number: Flyttalet som ska skrivas ut.
+********************************************************************************/
+void serial_print_double(const double number);
+
+/********************************************************************************
+* serial_print_char: Lägger ett enskilt tecken i sändbufferten för seriell
+*                    överföring.
+*
+*                    - character: Det tecken som ska skrivas ut.
+********************************************************************************/
+void serial_print_char(const char character);
+
+/********************************************************************************
+* serial_print_new_line: Sätter nästa utskrift till längst till vänster på 
+*                        nästa rad via utskrift av ett nyradstecken.
+********************************************************************************/
+static inline void serial_print_new_line(void)
+{
+   serial_print_string("\n");
+   return;
+}
+
 #endif /* SERIAL_H_ */
\ No newline at end of file
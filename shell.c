@@ -0,0 +1,173 @@
+/********************************************************************************
+* shell.c: Innehåller funktionsdefinitioner för kommandoskalet.
+********************************************************************************/
+#include "shell.h"
+
+/* Statiska variabler: */
+static const struct shell_command* command_table = 0; /* Pekare till kommandotabellen. */
+static uint8_t num_table_commands = 0;                /* Antalet kommandon i tabellen. */
+static char line[SHELL_LINE_SIZE];                    /* Rad som sätts samman. */
+static uint8_t line_length = 0;                       /* Antalet tecken på raden. */
+
+/* Statiska funktioner: */
+static void shell_execute(void);
+static void shell_print_help(void);
+static inline bool shell_equal(const char* s1,
+                               const char* s2);
+
+/********************************************************************************
+* shell_init: Initierar kommandoskalet med angiven kommandotabell.
+*
+*             - commands    : Pekare till kommandotabellen.
+*             - num_commands: Antalet kommandon i tabellen.
+********************************************************************************/
+void shell_init(const struct shell_command* commands,
+                const uint8_t num_commands)
+{
+   command_table = commands;
+   num_table_commands = num_commands;
+   line_length = 0;
+   SERIAL_PRINT_P("> ");
+   return;
+}
+
+/********************************************************************************
+* shell_poll: Hämtar samtliga mottagna tecken och sätter samman dessa till en
+*             rad. Både '\r' och '\n' tolkas som radslut, där tomma rader
+*             ignoreras så att terminaler som skickar "\r\n" fungerar.
+********************************************************************************/
+void shell_poll(void)
+{
+   char c;
+
+   while (serial_read_char(&c))
+   {
+      if (c == '\r' || c == '\n')
+      {
+         if (line_length)
+         {
+            serial_print_new_line();
+            line[line_length] = '\0';
+            shell_execute();
+            line_length = 0;
+            SERIAL_PRINT_P("> ");
+         }
+      }
+      else if (c == '\b' || c == 0x7F)
+      {
+         if (line_length)
+         {
+            line_length--;
+            SERIAL_PRINT_P("\b \b");
+         }
+      }
+      else if (c >= ' ' && line_length < SHELL_LINE_SIZE - 1)
+      {
+         line[line_length++] = c;
+         serial_print_char(c);
+      }
+   }
+   return;
+}
+
+/********************************************************************************
+* shell_parse_unsigned: Tolkar angiven text som ett osignerat decimalt heltal.
+*                       Tomma texter, andra tecken än siffror samt tal som
+*                       inte ryms i 32 bitar är ogiltiga.
+*
+*                       - s     : Pekare till texten som ska tolkas.
+*                       - number: Pekare till variabel där heltalet lagras.
+********************************************************************************/
+bool shell_parse_unsigned(const char* s,
+                          uint32_t* number)
+{
+   uint32_t result = 0;
+
+   if (!*s) return false;
+
+   for (const char* i = s; *i; ++i)
+   {
+      if (*i < '0' || *i > '9') return false;
+      const uint8_t digit = *i - '0';
+      if (result > (UINT32_MAX - digit) / 10) return false;
+      result = result * 10 + digit;
+   }
+
+   *number = result;
+   return true;
+}
+
+/********************************************************************************
+* shell_execute: Delar upp aktuell rad i ord, varefter kommandot slås upp i
+*                kommandotabellen och motsvarande kommandofunktion anropas.
+*                Orden avgränsas genom att blanksteg ersätts med nolltecken.
+*                Ord utöver SHELL_MAX_ARGS ignoreras.
+********************************************************************************/
+static void shell_execute(void)
+{
+   char* argv[SHELL_MAX_ARGS];
+   uint8_t argc = 0;
+   char* i = line;
+
+   while (*i && argc < SHELL_MAX_ARGS)
+   {
+      while (*i == ' ') *i++ = '\0';
+      if (!*i) break;
+      argv[argc++] = i;
+      while (*i && *i != ' ') i++;
+   }
+
+   *i = '\0';
+
+   if (!argc) return;
+
+   if (shell_equal(argv[0], "help"))
+   {
+      shell_print_help();
+      return;
+   }
+
+   for (uint8_t j = 0; j < num_table_commands; ++j)
+   {
+      if (shell_equal(argv[0], command_table[j].name))
+      {
+         command_table[j].handler(argc, argv);
+         return;
+      }
+   }
+
+   SERIAL_PRINT_P("Unknown command: ");
+   serial_print_string(argv[0]);
+   serial_print_new_line();
+   return;
+}
+
+/********************************************************************************
+* shell_print_help: Skriver ut hjälptexten för samtliga kommandon.
+********************************************************************************/
+static void shell_print_help(void)
+{
+   for (uint8_t i = 0; i < num_table_commands; ++i)
+   {
+      serial_print_string_P(command_table[i].usage);
+      serial_print_new_line();
+   }
+   return;
+}
+
+/********************************************************************************
+* shell_equal: Indikerar ifall två textstycken är identiska.
+*
+*              - s1: Pekare till det första textstycket.
+*              - s2: Pekare till det andra textstycket.
+********************************************************************************/
+static inline bool shell_equal(const char* s1,
+                               const char* s2)
+{
+   while (*s1 && *s1 == *s2)
+   {
+      s1++;
+      s2++;
+   }
+   return *s1 == *s2;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+/********************************************************************************
+* shell.h: Innehåller ett enkelt kommandoskal via seriell överföring. Mottagna
+*          tecken sätts samman till rader, som delas upp i ord separerade
+*          med blanksteg. Första ordet slås upp i en kommandotabell, varefter
+*          motsvarande kommandofunktion anropas med resterande ord som
+*          argument. Kommandot help skriver ut samtliga kommandon i tabellen.
+*
+*          Tolkningen sker helt i huvudloopen via funktionen shell_poll,
+*          som lämpligen körs som en task med serial_rx_available som
+*          väckningsvillkor (se task.h).
+*
+*          Exempel på kommandotabell:
+*
+*          static const char led_usage[] PROGMEM = "led <on|off>";
+*
+*          static const struct shell_command commands[] =
+*          {
+*             { "led", led_usage, led_command }
+*          };
+*
+*          shell_init(commands, sizeof(commands) / sizeof(commands[0]));
+********************************************************************************/
+#ifndef SHELL_H_
+#define SHELL_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+#include "serial.h"
+
+/* Makrodefinitioner: */
+#define SHELL_LINE_SIZE 32 /* Maximalt antal tecken per rad (inklusive nolltecken). */
+#define SHELL_MAX_ARGS 4   /* Maximalt antal ord per rad (inklusive kommandot). */
+
+/********************************************************************************
+* shell_command: Strukt för lagring av ett kommando i kommandotabellen.
+********************************************************************************/
+struct shell_command
+{
+   const char* name;                         /* Kommandots namn. */
+   PGM_P usage;                              /* Hjälptext i programminnet som skrivs ut via help. */
+   void (*handler)(uint8_t argc, char** argv); /* Kommandofunktion, argv[0] är namnet. */
+};
+
+/********************************************************************************
+* shell_init: Initierar kommandoskalet med angiven kommandotabell, följt av
+*             att en prompt skrivs ut.
+*
+*             - commands    : Pekare till kommandotabellen.
+*             - num_commands: Antalet kommandon i tabellen.
+********************************************************************************/
+void shell_init(const struct shell_command* commands,
+                const uint8_t num_commands);
+
+/********************************************************************************
+* shell_poll: Hämtar samtliga mottagna tecken och sätter samman dessa till en
+*             rad, som ekas tillbaka. Backsteg tar bort senaste tecken. Vid
+*             radslut tolkas och exekveras raden. Tecken utöver radens
+*             maximala längd ignoreras.
+********************************************************************************/
+void shell_poll(void);
+
+/********************************************************************************
+* shell_parse_unsigned: Tolkar angiven text som ett osignerat decimalt heltal.
+*                       Ifall texten inte är ett giltigt heltal returneras
+*                       false, annars returneras true.
+*
+*                       - s     : Pekare till texten som ska tolkas.
+*                       - number: Pekare till variabel där heltalet lagras.
+********************************************************************************/
+bool shell_parse_unsigned(const char* s,
+                          uint32_t* number);
+
+#endif /* SHELL_H_ */
\ No newline at end of file
@@ -0,0 +1,483 @@
+/********************************************************************************
+* soft_timer.c: Innehåller definitioner av associerade funktioner för strukten
+*               soft_timer samt timerhjulet som driver samtliga mjukvarutimers.
+********************************************************************************/
+#include "soft_timer.h"
+#include "sysclock.h"
+#include "isr_probe.h"
+
+/* Makrodefinitioner: */
+#define SOFT_TIMER_WHEEL_MASK (SOFT_TIMER_WHEEL_SIZE - 1) /* Mask för val av fack. */
+
+/* Statiska variabler: */
+static struct soft_timer* wheel[SOFT_TIMER_WHEEL_SIZE]; /* Timerhjulets fack. */
+static struct timer tick_timer;                         /* Hårdvarutimer som utgör tickkälla. */
+static volatile uint32_t current_tick = 0;              /* Antalet passerade tick. */
+static uint32_t processed_tick = 0;                     /* Senast hanterade tick. */
+static bool tickless = false;                           /* Indikerar tickless-läge. */
+static bool (*pending_check)(void) = 0;                 /* Kontroll av väntande arbete inför sleep. */
+
+/* Statiska funktioner: */
+static void soft_timer_insert(struct soft_timer* self);
+static void soft_timer_remove(struct soft_timer* self);
+static inline uint32_t soft_timer_get_ticks(const uint32_t time_ms);
+static inline uint32_t soft_timer_current_tick(void);
+static bool soft_timer_next_expiry(uint32_t* expires);
+static void soft_timer_expire(struct soft_timer* self,
+                              const uint32_t now);
+static void soft_timer_update_stats(struct soft_timer* self,
+                                    const uint32_t now);
+
+/********************************************************************************
+* soft_timer_wheel_init: Initierar timerhjulet samt angiven hårdvarutimer, som
+*                        genererar ett tick var SOFT_TIMER_TICK_MS:e
+*                        millisekund. Avbrottsrutinen för vald timerkrets
+*                        måste anropa funktionen soft_timer_tick.
+*
+*                        - timer_sel: Timerkretsen som ska användas som tickkälla.
+********************************************************************************/
+void soft_timer_wheel_init(const enum timer_sel timer_sel)
+{
+   for (uint8_t i = 0; i < SOFT_TIMER_WHEEL_SIZE; ++i)
+   {
+      wheel[i] = 0;
+   }
+
+   current_tick = 0;
+   processed_tick = 0;
+   tickless = false;
+   timer_init_ms(&tick_timer, timer_sel, SOFT_TIMER_TICK_MS);
+   timer_enable_interrupt(&tick_timer);
+   return;
+}
+
+/********************************************************************************
+* soft_timer_wheel_init_tickless: Initierar timerhjulet i tickless-läge, där
+*                                 aktuellt tick hämtas från tidsbasen i
+*                                 sysclock (Timer 1) i stället för att räknas
+*                                 upp av ett periodiskt avbrott. Inför sleep
+*                                 ställs ett alarm in på närmast utgående
+*                                 timer via funktionen soft_timer_sleep.
+********************************************************************************/
+void soft_timer_wheel_init_tickless(void)
+{
+   for (uint8_t i = 0; i < SOFT_TIMER_WHEEL_SIZE; ++i)
+   {
+      wheel[i] = 0;
+   }
+
+   sysclock_init();
+   tickless = true;
+   processed_tick = soft_timer_current_tick();
+   return;
+}
+
+/********************************************************************************
+* soft_timer_init: Initierar ny mjukvarutimer med angiven callbackrutin.
+*                  Timern är inaktiverad tills den startas.
+*
+*                  - self    : Pekare till timern som ska initieras.
+*                  - callback: Callbackrutin som anropas när timern löper ut.
+*                  - arg     : Argument som skickas till callbackrutinen.
+********************************************************************************/
+void soft_timer_init(struct soft_timer* self,
+                     void (*callback)(void* arg),
+                     void* arg)
+{
+   self->next = 0;
+   self->prev = 0;
+   self->expires = 0;
+   self->period = 0;
+   self->callback = callback;
+   self->arg = arg;
+   self->active = false;
+   self->coalesce = false;
+   soft_timer_reset_stats(self);
+   return;
+}
+
+/********************************************************************************
+* soft_timer_reset_stats: Nollställer statistiken för angiven timer.
+*
+*                         - self: Pekare till timern vars statistik ska
+*                                 nollställas.
+********************************************************************************/
+void soft_timer_reset_stats(struct soft_timer* self)
+{
+   self->stats.runs = 0;
+   self->stats.overruns = 0;
+   self->stats.lateness_min_us = UINT32_MAX;
+   self->stats.lateness_max_us = 0;
+   self->stats.lateness_avg_us = 0;
+   return;
+}
+
+/********************************************************************************
+* soft_timer_start: Startar angiven timer som engångstimer, som löper ut en
+*                   gång efter angiven tid. Ifall timern redan är aktiverad
+*                   startas den om.
+*
+*                   - self    : Pekare till timern som ska startas.
+*                   - delay_ms: Tiden tills timern löper ut mätt i millisekunder.
+********************************************************************************/
+void soft_timer_start(struct soft_timer* self,
+                      const uint32_t delay_ms)
+{
+   soft_timer_stop(self);
+   self->period = 0;
+   self->expires = processed_tick + soft_timer_get_ticks(delay_ms);
+   soft_timer_insert(self);
+   return;
+}
+
+/********************************************************************************
+* soft_timer_start_periodic: Startar angiven timer som periodisk timer, som
+*                            löper ut kontinuerligt med angiven periodtid.
+*                            Ifall timern redan är aktiverad startas den om.
+*
+*                            - self     : Pekare till timern som ska startas.
+*                            - period_ms: Periodtiden mätt i millisekunder.
+********************************************************************************/
+void soft_timer_start_periodic(struct soft_timer* self,
+                               const uint32_t period_ms)
+{
+   soft_timer_stop(self);
+   self->period = soft_timer_get_ticks(period_ms);
+   self->expires = processed_tick + self->period;
+   soft_timer_insert(self);
+   return;
+}
+
+/********************************************************************************
+* soft_timer_stop: Stoppar angiven timer, som tas bort ur timerhjulet.
+*
+*                  - self: Pekare till timern som ska stoppas.
+********************************************************************************/
+void soft_timer_stop(struct soft_timer* self)
+{
+   if (self->active)
+   {
+      soft_timer_remove(self);
+   }
+   return;
+}
+
+/********************************************************************************
+* soft_timer_tick: Räknar upp aktuellt tick. Funktionen ska anropas från
+*                  avbrottsrutinen för tickkällan och tar konstant tid
+*                  oavsett antalet aktiverade timers. Tiden per tick kan
+*                  mätas via isr_probe.h (ISR_PROBE_SOFT_TICK).
+********************************************************************************/
+void soft_timer_tick(void)
+{
+   ISR_PROBE_ENTER(ISR_PROBE_NO_LATENCY);
+   current_tick++;
+   ISR_PROBE_EXIT(ISR_PROBE_SOFT_TICK);
+   return;
+}
+
+/********************************************************************************
+* soft_timer_run: Hanterar samtliga tick som har passerat sedan föregående
+*                 anrop. För varje tick gås endast motsvarande fack igenom,
+*                 där timers vars utgångstick är uppnått tas bort och får sin
+*                 callbackrutin anropad. Periodiska timers sätts sedan in på
+*                 nytt med sin periodtid räknat från utgångsticket (inte
+*                 från aktuell tid), så att timern inte driver över tid. Facket
+*                 gås igenom från början efter varje callback, eftersom
+*                 callbackrutinen kan ha startat eller stoppat andra timers.
+*                 Anrop där minst ett tick hanteras mäts via isr_probe.h
+*                 (ISR_PROBE_SOFT_RUN), inklusive callbackrutinerna.
+********************************************************************************/
+void soft_timer_run(void)
+{
+   const uint32_t now = soft_timer_current_tick();
+   if (processed_tick == now) return;
+   ISR_PROBE_ENTER(ISR_PROBE_NO_LATENCY);
+
+   while (processed_tick != now)
+   {
+      struct soft_timer* self = wheel[++processed_tick & SOFT_TIMER_WHEEL_MASK];
+
+      while (self)
+      {
+         if (self->expires == processed_tick)
+         {
+            soft_timer_expire(self, now);
+            self = wheel[processed_tick & SOFT_TIMER_WHEEL_MASK];
+         }
+         else
+         {
+            self = self->next;
+         }
+      }
+   }
+
+   ISR_PROBE_EXIT(ISR_PROBE_SOFT_RUN);
+   return;
+}
+
+/********************************************************************************
+* soft_timer_expire: Hanterar angiven timer som har löpt ut. Statistiken
+*                    uppdateras och periodiska timers sätts in på nytt med
+*                    nästa absoluta utgångstid, följt av att timerns
+*                    callbackrutin anropas.
+*
+*                    Ifall även nästa utgångstid redan har passerats har
+*                    minst en period missats. Vid sammanslagning hoppas
+*                    samtliga missade perioder över och räknas som overruns,
+*                    annars körs de i efterhand och räknas en i taget.
+*
+*                    - self: Pekare till timern som har löpt ut.
+*                    - now : Aktuellt tick.
+********************************************************************************/
+static void soft_timer_expire(struct soft_timer* self,
+                              const uint32_t now)
+{
+   soft_timer_remove(self);
+   soft_timer_update_stats(self, now);
+
+   if (self->period)
+   {
+      self->expires += self->period;
+
+      if ((int32_t)(now - self->expires) >= 0)
+      {
+         if (self->coalesce)
+         {
+            const uint32_t missed = (now - self->expires) / self->period + 1;
+            self->expires += missed * self->period;
+            self->stats.overruns += missed;
+         }
+         else
+         {
+            self->stats.overruns++;
+         }
+      }
+      soft_timer_insert(self);
+   }
+
+   self->callback(self->arg);
+   return;
+}
+
+/********************************************************************************
+* soft_timer_update_stats: Uppdaterar statistiken för angiven timer, som just
+*                          har löpt ut. Fördröjningen mäts i mikrosekunder
+*                          via tidsbasen i tickless-läge, annars i hela tick.
+*
+*                          - self: Pekare till timern som har löpt ut.
+*                          - now : Aktuellt tick.
+********************************************************************************/
+static void soft_timer_update_stats(struct soft_timer* self,
+                                    const uint32_t now)
+{
+   struct soft_timer_stats* stats = &self->stats;
+   uint32_t lateness_us;
+
+   if (tickless)
+   {
+      lateness_us = sysclock_micros() - self->expires * SOFT_TIMER_TICK_MS * 1000UL;
+   }
+   else
+   {
+      lateness_us = (now - self->expires) * SOFT_TIMER_TICK_MS * 1000UL;
+   }
+
+   if (lateness_us < stats->lateness_min_us) stats->lateness_min_us = lateness_us;
+   if (lateness_us > stats->lateness_max_us) stats->lateness_max_us = lateness_us;
+
+   if (stats->runs++ == 0)
+   {
+      stats->lateness_avg_us = lateness_us;
+   }
+   else
+   {
+      stats->lateness_avg_us += ((int32_t)(lateness_us - stats->lateness_avg_us)) / 16;
+   }
+   return;
+}
+
+/********************************************************************************
+* soft_timer_set_pending_check: Registrerar en funktion som indikerar ifall
+*                               det finns väntande arbete i huvudloopen.
+*
+*                               - pending: Funktion som returnerar true när
+*                                          arbete väntar (0 för ingen kontroll).
+********************************************************************************/
+void soft_timer_set_pending_check(bool (*pending)(void))
+{
+   pending_check = pending;
+   return;
+}
+
+/********************************************************************************
+* soft_timer_sleep: Försätter processorn i Idle Mode tills nästa avbrott.
+*
+*                   I tickless-läge ställs först ett alarm in på närmast
+*                   utgående timer. Ifall denna redan har löpt ut sker ingen
+*                   sleep, så att timern kan hanteras direkt. Saknas aktiverade
+*                   timers ställs inget alarm in, varvid processorn sover tills
+*                   något annat avbrott äger rum. Ingen sleep sker heller
+*                   ifall registrerad kontroll (se soft_timer_set_pending_check)
+*                   indikerar väntande arbete, som exempelvis kan ha
+*                   signalerats från en avbrottsrutin efter senaste hanteringen.
+*
+*                   Avbrott inaktiveras under kontrollen inför sleep och
+*                   återaktiveras direkt före instruktionen SLEEP. Eftersom
+*                   instruktionen efter SEI alltid exekveras före nästa
+*                   avbrott kan ett avbrott inte gå förlorat däremellan.
+********************************************************************************/
+void soft_timer_sleep(void)
+{
+   bool ready_to_sleep = true;
+   bool alarm_needed = false;
+   uint32_t expires;
+
+   if (tickless)
+   {
+      if (soft_timer_next_expiry(&expires))
+      {
+         alarm_needed = true;
+         ready_to_sleep = sysclock_set_alarm(expires * SOFT_TIMER_TICK_MS);
+      }
+      else
+      {
+         sysclock_cancel_alarm();
+      }
+   }
+
+   set_sleep_mode(SLEEP_MODE_IDLE);
+   asm("CLI");
+
+   if (tickless)
+   {
+      ready_to_sleep = ready_to_sleep && (!alarm_needed || sysclock_alarm_armed());
+   }
+   else
+   {
+      ready_to_sleep = current_tick == processed_tick;
+   }
+
+   if (pending_check)
+   {
+      ready_to_sleep = ready_to_sleep && !pending_check();
+   }
+
+   if (ready_to_sleep)
+   {
+      sleep_enable();
+      asm("SEI");
+      sleep_cpu();
+      sleep_disable();
+   }
+   else
+   {
+      asm("SEI");
+   }
+   return;
+}
+
+/********************************************************************************
+* soft_timer_insert: Sätter in angiven timer först i det fack som motsvarar
+*                    timerns utgångstick.
+*
+*                    - self: Pekare till timern som ska sättas in.
+********************************************************************************/
+static void soft_timer_insert(struct soft_timer* self)
+{
+   struct soft_timer** slot = &wheel[self->expires & SOFT_TIMER_WHEEL_MASK];
+   self->prev = 0;
+   self->next = *slot;
+   if (*slot) (*slot)->prev = self;
+   *slot = self;
+   self->active = true;
+   return;
+}
+
+/********************************************************************************
+* soft_timer_remove: Tar bort angiven timer ur sitt fack i timerhjulet.
+*
+*                    - self: Pekare till timern som ska tas bort.
+********************************************************************************/
+static void soft_timer_remove(struct soft_timer* self)
+{
+   if (self->prev)
+   {
+      self->prev->next = self->next;
+   }
+   else
+   {
+      wheel[self->expires & SOFT_TIMER_WHEEL_MASK] = self->next;
+   }
+
+   if (self->next) self->next->prev = self->prev;
+   self->next = 0;
+   self->prev = 0;
+   self->active = false;
+   return;
+}
+
+/********************************************************************************
+* soft_timer_get_ticks: Returnerar antalet tick som motsvarar angiven tid,
+*                       där minsta returvärde är ett tick.
+*
+*                       - time_ms: Tiden mätt i millisekunder.
+********************************************************************************/
+static inline uint32_t soft_timer_get_ticks(const uint32_t time_ms)
+{
+   const uint32_t ticks = time_ms / SOFT_TIMER_TICK_MS;
+   return ticks ? ticks : 1;
+}
+
+/********************************************************************************
+* soft_timer_current_tick: Returnerar aktuellt tick. I tickless-läge hämtas
+*                          aktuellt tick från tidsbasen. Annars inaktiveras
+*                          avbrott under avläsningen, då 32-bitarsvärdet läses
+*                          en byte i taget och annars kan uppdateras mitt i
+*                          läsningen.
+********************************************************************************/
+static inline uint32_t soft_timer_current_tick(void)
+{
+   if (tickless) return sysclock_millis() / SOFT_TIMER_TICK_MS;
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint32_t tick = current_tick;
+   SREG = sreg;
+   return tick;
+}
+
+/********************************************************************************
+* soft_timer_next_expiry: Söker igenom samtliga fack efter den aktiverade timer
+*                         som löper ut först. Utgångsticket lagras via angiven
+*                         pekare och true returneras. Ifall inga timers är
+*                         aktiverade returneras false. Sökningen tar linjär tid
+*                         i antalet timers, men sker endast inför sleep, och
+*                         mäts via isr_probe.h (ISR_PROBE_SOFT_NEXT).
+*
+*                         - expires: Pekare till variabel där närmaste
+*                                    utgångstick ska lagras.
+********************************************************************************/
+static bool soft_timer_next_expiry(uint32_t* expires)
+{
+   ISR_PROBE_ENTER(ISR_PROBE_NO_LATENCY);
+   bool found = false;
+   uint32_t nearest = 0;
+
+   for (uint8_t i = 0; i < SOFT_TIMER_WHEEL_SIZE; ++i)
+   {
+      for (const struct soft_timer* self = wheel[i]; self; self = self->next)
+      {
+         const uint32_t remaining = self->expires - processed_tick;
+
+         if (!found || remaining < nearest)
+         {
+            nearest = remaining;
+            found = true;
+         }
+      }
+   }
+
+   *expires = processed_tick + nearest;
+   ISR_PROBE_EXIT(ISR_PROBE_SOFT_NEXT);
+   return found;
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+/********************************************************************************
+* soft_timer.h: Innehåller drivrutiner för mjukvarutimers via strukten
+*               soft_timer samt associerade funktioner. Ett godtyckligt antal
+*               engångstimers samt periodiska timers drivs av en och samma
+*               hårdvarutimer, som genererar ett tick var millisekund.
+*
+*               Timrarna lagras i ett hashat timerhjul bestående av
+*               SOFT_TIMER_WHEEL_SIZE fack, där varje timer placeras i
+*               facket som motsvarar det tick den löper ut på. Insättning
+*               samt borttagning sker därmed i konstant tid. Avbrottsrutinen
+*               räknar endast upp aktuellt tick, vilket gör att tiden i
+*               avbrottsrutinen är densamma oavsett antalet timers. Utgångna
+*               timers hanteras i stället i huvudloopen via anrop av
+*               funktionen soft_timer_run, där respektive callbackrutin anropas.
+*
+*               I tickless-läge (se soft_timer_wheel_init_tickless) används
+*               inget periodiskt tick. Aktuell tid hämtas i stället från
+*               tidsbasen i sysclock, och inför sleep programmeras ett
+*               compare-alarm på Timer 1 för närmast utgående timer, där
+*               långa väntetider kedjas via timerns overflow-avbrott.
+*               Processorn sover då i Idle Mode mellan varje händelse.
+*
+*               Exempel på användning med Timer 2 som tickkälla:
+*
+*               ISR (TIMER2_COMPA_vect)
+*               {
+*                  soft_timer_tick();
+*               }
+*
+*               int main(void)
+*               {
+*                  soft_timer_wheel_init(TIMER_SEL_2);
+*                  soft_timer_init(&blink_timer, blink, &l1);
+*                  soft_timer_start_periodic(&blink_timer, 50);
+*
+*                  while (1)
+*                  {
+*                     soft_timer_run();
+*                     soft_timer_sleep();
+*                  }
+*               }
+********************************************************************************/
+#ifndef SOFT_TIMER_H_
+#define SOFT_TIMER_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+#include "timer.h"
+
+/* Makrodefinitioner: */
+#define SOFT_TIMER_TICK_MS 1     /* Tid mellan varje tick från hårdvarutimern. */
+#define SOFT_TIMER_WHEEL_SIZE 32 /* Antal fack i timerhjulet (måste vara en tvåpotens). */
+#define SOFT_TIMER_TIME_MAX_MS ((uint32_t)INT32_MAX) /* Längsta tid, så att utgångstick kan jämföras med tecken. */
+
+/********************************************************************************
+* soft_timer_stats: Strukt för lagring av statistik för en mjukvarutimer.
+*                   Fördröjningen mäts från timerns utgångstidpunkt till dess
+*                   att callbackrutinen anropas, vilket utgör timerns jitter.
+********************************************************************************/
+struct soft_timer_stats
+{
+   uint32_t runs;            /* Antal anrop av callbackrutinen. */
+   uint32_t overruns;        /* Antal perioder som har missats eller körts i efterhand. */
+   uint32_t lateness_min_us; /* Minsta fördröjning mätt i mikrosekunder. */
+   uint32_t lateness_max_us; /* Största fördröjning mätt i mikrosekunder. */
+   uint32_t lateness_avg_us; /* Glidande medelvärde av fördröjningen (1/16 per anrop). */
+};
+
+/********************************************************************************
+* soft_timer: Strukt för implementering av mjukvarutimers, som löper ut efter
+*             angiven tid och då anropar en callbackrutin. Timern kan antingen
+*             köras som engångstimer eller som periodisk timer.
+********************************************************************************/
+struct soft_timer
+{
+   struct soft_timer* next;     /* Pekare till nästa timer i samma fack. */
+   struct soft_timer* prev;     /* Pekare till föregående timer i samma fack. */
+   uint32_t expires;            /* Tick då timern löper ut. */
+   uint32_t period;             /* Periodtid mätt i ticks (0 för engångstimer). */
+   void (*callback)(void* arg); /* Callbackrutin som anropas när timern löper ut. */
+   void* arg;                   /* Argument som skickas till callbackrutinen. */
+   bool active;                 /* Indikerar ifall timern är aktiverad. */
+   bool coalesce;               /* Indikerar ifall missade perioder ska slås ihop. */
+   struct soft_timer_stats stats; /* Statistik över fördröjning samt missade perioder. */
+};
+
+/********************************************************************************
+* soft_timer_wheel_init: Initierar timerhjulet samt angiven hårdvarutimer, som
+*                        genererar ett tick var SOFT_TIMER_TICK_MS:e
+*                        millisekund. Avbrottsrutinen för vald timerkrets
+*                        måste anropa funktionen soft_timer_tick, se
+*                        timer_enable_interrupt för respektive avbrottsvektor.
+*
+*                        - timer_sel: Timerkretsen som ska användas som tickkälla.
+********************************************************************************/
+void soft_timer_wheel_init(const enum timer_sel timer_sel);
+
+/********************************************************************************
+* soft_timer_wheel_init_tickless: Initierar timerhjulet i tickless-läge, där
+*                                 aktuell tid hämtas från tidsbasen i sysclock
+*                                 (Timer 1), som också initieras. Inget
+*                                 periodiskt tick används, utan processorn
+*                                 väcks via alarm när närmaste timer löper ut.
+********************************************************************************/
+void soft_timer_wheel_init_tickless(void);
+
+/********************************************************************************
+* soft_timer_init: Initierar ny mjukvarutimer med angiven callbackrutin.
+*                  Timern är inaktiverad tills den startas.
+*
+*                  - self    : Pekare till timern som ska initieras.
+*                  - callback: Callbackrutin som anropas när timern löper ut.
+*                  - arg     : Argument som skickas till callbackrutinen.
+********************************************************************************/
+void soft_timer_init(struct soft_timer* self,
+                     void (*callback)(void* arg),
+                     void* arg);
+
+/********************************************************************************
+* soft_timer_start: Startar angiven timer som engångstimer, som löper ut en
+*                   gång efter angiven tid (högst SOFT_TIMER_TIME_MAX_MS).
+*                   Ifall timern redan är aktiverad startas den om.
+*
+*                   - self    : Pekare till timern som ska startas.
+*                   - delay_ms: Tiden tills timern löper ut mätt i millisekunder.
+********************************************************************************/
+void soft_timer_start(struct soft_timer* self,
+                      const uint32_t delay_ms);
+
+/********************************************************************************
+* soft_timer_start_periodic: Startar angiven timer som periodisk timer, som
+*                            löper ut kontinuerligt med angiven periodtid
+*                            (högst SOFT_TIMER_TIME_MAX_MS). Ifall timern
+*                            redan är aktiverad startas den om.
+*
+*                            - self     : Pekare till timern som ska startas.
+*                            - period_ms: Periodtiden mätt i millisekunder.
+********************************************************************************/
+void soft_timer_start_periodic(struct soft_timer* self,
+                               const uint32_t period_ms);
+
+/********************************************************************************
+* soft_timer_set_coalesce: Väljer hur en periodisk timer hanterar perioder som
+*                          har passerat innan callbackrutinen hann anropas.
+*
+*                          Periodiska timers räknar fram nästa utgångstid genom
+*                          att addera periodtiden till föregående utgångstid,
+*                          vilket gör att timern inte driver över tid. Som
+*                          default körs varje missad period i efterhand
+*                          (catch-up). Vid sammanslagning hoppas i stället
+*                          samtliga missade perioder över, så att nästa anrop
+*                          sker på nästa utgångstid som ligger i framtiden.
+*                          Missade perioder räknas i båda fallen i statistiken.
+*
+*                          - self    : Pekare till timern.
+*                          - coalesce: true för att slå ihop missade perioder.
+********************************************************************************/
+static inline void soft_timer_set_coalesce(struct soft_timer* self,
+                                           const bool coalesce)
+{
+   self->coalesce = coalesce;
+   return;
+}
+
+/********************************************************************************
+* soft_timer_reset_stats: Nollställer statistiken för angiven timer.
+*
+*                         - self: Pekare till timern vars statistik ska
+*                                 nollställas.
+********************************************************************************/
+void soft_timer_reset_stats(struct soft_timer* self);
+
+/********************************************************************************
+* soft_timer_stop: Stoppar angiven timer, som tas bort ur timerhjulet.
+*
+*                  - self: Pekare till timern som ska stoppas.
+********************************************************************************/
+void soft_timer_stop(struct soft_timer* self);
+
+/********************************************************************************
+* soft_timer_active: Indikerar ifall angiven timer är aktiverad.
+*
+*                    - self: Pekare till timern som ska kontrolleras.
+********************************************************************************/
+static inline bool soft_timer_active(const struct soft_timer* self)
+{
+   return self->active;
+}
+
+/********************************************************************************
+* soft_timer_tick: Räknar upp aktuellt tick. Funktionen ska anropas från
+*                  avbrottsrutinen för tickkällan och tar konstant tid
+*                  oavsett antalet aktiverade timers.
+********************************************************************************/
+void soft_timer_tick(void);
+
+/********************************************************************************
+* soft_timer_run: Hanterar samtliga tick som har passerat sedan föregående
+*                 anrop, där callbackrutinen för varje utgången timer anropas.
+*                 Periodiska timers startas om med sin periodtid. Funktionen
+*                 ska anropas kontinuerligt från huvudloopen. Start samt stopp
+*                 av timers får endast ske från huvudloopen eller från
+*                 callbackrutiner, inte från avbrottsrutiner.
+********************************************************************************/
+void soft_timer_run(void);
+
+/********************************************************************************
+* soft_timer_set_pending_check: Registrerar en funktion som indikerar ifall
+*                               det finns väntande arbete i huvudloopen,
+*                               exempelvis tasks som har signalerats från en
+*                               avbrottsrutin (se task.h). Funktionen anropas
+*                               med avbrott inaktiverade inför varje sleep,
+*                               som då inte genomförs så länge arbete väntar.
+*
+*                               - pending: Funktion som returnerar true när
+*                                          arbete väntar (0 för ingen kontroll).
+********************************************************************************/
+void soft_timer_set_pending_check(bool (*pending)(void));
+
+/********************************************************************************
+* soft_timer_sleep: Försätter processorn i Idle Mode tills nästa avbrott.
+*                   I tickless-läge ställs först ett alarm in på närmast
+*                   utgående timer, så att processorn väcks i tid. Funktionen
+*                   ska anropas i huvudloopen direkt efter soft_timer_run.
+*                   Väckningsfelet kan mätas i simavr genom att jämföra
+*                   tidpunkten för compare-avbrottet mot timerns utgångstid.
+********************************************************************************/
+void soft_timer_sleep(void);
+
+#endif /* SOFT_TIMER_H_ */
\ No newline at end of file
@@ -0,0 +1,331 @@
+/********************************************************************************
+* sysclock.c: Innehåller funktionsdefinitioner samt avbrottsrutiner för
+*             systemets tidsbas implementerad via Timer 1.
+********************************************************************************/
+#include "sysclock.h"
+#include "isr_probe.h"
+
+/* Makrodefinitioner: */
+#define SYSCLOCK_OVERFLOW_PERIOD_US (65536UL / SYSCLOCK_COUNTS_PER_US) /* Tid per overflow. */
+#define SYSCLOCK_OVERFLOW_MS (SYSCLOCK_OVERFLOW_PERIOD_US / 1000) /* Hela millisekunder per overflow. */
+#define SYSCLOCK_OVERFLOW_US (SYSCLOCK_OVERFLOW_PERIOD_US % 1000) /* Resterande mikrosekunder per overflow. */
+#define SYSCLOCK_ALARM_MARGIN 64    /* Minsta antal räknarsteg framåt för ett alarm. */
+#define SYSCLOCK_ALARM_MAX_MS 60000 /* Längsta tid framåt som ett alarm kan ställas in. */
+
+#if SYSCLOCK_PRESCALER == 1
+#define SYSCLOCK_CLOCK_SELECT (1 << CS10) /* Bitar CS12 - CS10 för prescaler 1. */
+#else
+#define SYSCLOCK_CLOCK_SELECT (1 << CS11) /* Bitar CS12 - CS10 för prescaler 8. */
+#endif
+
+/* Statiska variabler: */
+static volatile uint16_t overflows = 0;      /* Antalet overflows sedan initieringen. */
+static volatile uint32_t millis = 0;         /* Antalet hela millisekunder vid senaste overflow. */
+static volatile uint16_t micros_rest = 0;    /* Mikrosekunder utöver millis vid senaste overflow. */
+static volatile bool alarm_armed = false;    /* Indikerar ifall ett alarm är inställt. */
+static volatile uint16_t alarm_overflow = 0; /* Overflow-intervall då alarmet ska lösa ut. */
+static volatile uint8_t sequence = 0;        /* Sekvensnummer, räknas upp vid varje overflow. */
+
+/********************************************************************************
+* sysclock_snapshot: Strukt för lagring av en konsistent avläsning av tidsbasen.
+********************************************************************************/
+struct sysclock_snapshot
+{
+   uint32_t millis;    /* Hela millisekunder vid senaste overflow. */
+   uint16_t micros;    /* Mikrosekunder utöver millis fram till avläsningen. */
+   uint16_t overflows; /* Antalet overflows fram till avläsningen. */
+   uint16_t count;     /* Avläst värde i TCNT1. */
+};
+
+/* Statiska funktioner: */
+static void sysclock_read(struct sysclock_snapshot* snapshot);
+static inline uint16_t sysclock_read_count(void);
+
+/********************************************************************************
+* sysclock_init: Initierar tidsbasen, som startar från noll. Timer 1 sätts i
+*                Normal Mode med prescaler SYSCLOCK_PRESCALER och
+*                overflow-avbrott aktiveras.
+********************************************************************************/
+void sysclock_init(void)
+{
+   asm("CLI");
+   overflows = 0;
+   millis = 0;
+   micros_rest = 0;
+   alarm_armed = false;
+   sequence = 0;
+
+   TCCR1A = 0x00;
+   TCCR1B = SYSCLOCK_CLOCK_SELECT;
+   TCNT1 = 0x00;
+   TIFR1 = (1 << TOV1) | (1 << OCF1A);
+   TIMSK1 = (1 << TOIE1);
+   asm("SEI");
+   return;
+}
+
+/********************************************************************************
+* sysclock_millis: Returnerar antalet millisekunder som har passerat sedan
+*                  tidsbasen initierades.
+********************************************************************************/
+uint32_t sysclock_millis(void)
+{
+   struct sysclock_snapshot snapshot;
+   sysclock_read(&snapshot);
+   return snapshot.millis + snapshot.micros / 1000;
+}
+
+/********************************************************************************
+* sysclock_micros: Returnerar antalet mikrosekunder som har passerat sedan
+*                  tidsbasen initierades.
+********************************************************************************/
+uint32_t sysclock_micros(void)
+{
+   struct sysclock_snapshot snapshot;
+   sysclock_read(&snapshot);
+   return snapshot.millis * 1000 + snapshot.micros;
+}
+
+/********************************************************************************
+* sysclock_cycles: Returnerar antalet klockcykler som har passerat sedan
+*                  tidsbasen initierades, där antalet overflows utgör de
+*                  högsta 16 bitarna och TCNT1 de lägsta 16 bitarna av
+*                  räknarvärdet, som multipliceras med prescalern.
+********************************************************************************/
+uint32_t sysclock_cycles(void)
+{
+   struct sysclock_snapshot snapshot;
+   sysclock_read(&snapshot);
+   return (((uint32_t)snapshot.overflows << 16) | snapshot.count) * SYSCLOCK_PRESCALER;
+}
+
+/********************************************************************************
+* sysclock_extend: Utökar ett 16-bitars räknarvärde från Timer 1 till 32 bitar,
+*                  där antalet overflows utgör de högsta 16 bitarna, och
+*                  omvandlar resultatet till klockcykler likt sysclock_cycles.
+*
+*                  Ifall flaggan TOV1 är ettställd har ett overflow skett som
+*                  motsvarande avbrottsrutin ännu inte har hunnit hantera.
+*                  Ett lågt räknarvärde har då fångats efter detta overflow,
+*                  medan ett högt räknarvärde fångades innan overflow.
+*
+*                  - count: Räknarvärdet som ska utökas.
+********************************************************************************/
+uint32_t sysclock_extend(const uint16_t count)
+{
+   uint16_t overflow = overflows;
+
+   if ((TIFR1 & (1 << TOV1)) && count < 0x8000)
+   {
+      overflow++;
+   }
+   return (((uint32_t)overflow << 16) | count) * SYSCLOCK_PRESCALER;
+}
+
+/********************************************************************************
+* sysclock_set_alarm: Ställer in ett alarm, som löser ut via compare-avbrott när
+*                     angiven tidpunkt mätt i millisekunder uppnås. Ett
+*                     tidigare inställt alarm ersätts.
+*
+*                     Tiden kvar till alarmet omvandlas till räknarsteg, som
+*                     adderas till tidsbasens aktuella 32-bitars räknarvärde
+*                     (antalet overflows följt av TCNT1). De lägsta 16 bitarna
+*                     skrivs till OCR1A, medan de högsta 16 bitarna anger
+*                     i vilket overflow-intervall compare-avbrott ska aktiveras.
+*
+*                     Ifall angiven tidpunkt redan har passerats ställs inget
+*                     alarm in och false returneras, annars returneras true.
+*
+*                     - wake_ms: Tidpunkten då alarmet ska lösa ut, mätt i
+*                                millisekunder sedan initieringen.
+********************************************************************************/
+bool sysclock_set_alarm(const uint32_t wake_ms)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+
+   uint16_t count = TCNT1;
+   uint16_t overflow = overflows;
+   uint32_t elapsed_us = micros_rest + count / SYSCLOCK_COUNTS_PER_US;
+   int32_t remaining_ms = (int32_t)(wake_ms - millis);
+
+   if ((TIFR1 & (1 << TOV1)) && count < 0x8000)
+   {
+      overflow++;
+      elapsed_us += (uint32_t)SYSCLOCK_OVERFLOW_MS * 1000 + SYSCLOCK_OVERFLOW_US;
+   }
+
+   if (remaining_ms > SYSCLOCK_ALARM_MAX_MS) remaining_ms = SYSCLOCK_ALARM_MAX_MS;
+   const int32_t remaining_us = remaining_ms * 1000 - (int32_t)elapsed_us;
+
+   if (remaining_us < (int32_t)(SYSCLOCK_ALARM_MARGIN / SYSCLOCK_COUNTS_PER_US))
+   {
+      alarm_armed = false;
+      TIMSK1 &= ~(1 << OCIE1A);
+      SREG = sreg;
+      return false;
+   }
+
+   const uint32_t now = ((uint32_t)overflow << 16) | count;
+   const uint32_t target = now + (uint32_t)remaining_us * SYSCLOCK_COUNTS_PER_US;
+
+   OCR1A = (uint16_t)target;
+   alarm_overflow = (uint16_t)(target >> 16);
+   alarm_armed = true;
+
+   if (alarm_overflow == overflows)
+   {
+      TIFR1 = (1 << OCF1A);
+      TIMSK1 |= (1 << OCIE1A);
+   }
+   else
+   {
+      TIMSK1 &= ~(1 << OCIE1A);
+   }
+
+   SREG = sreg;
+   return true;
+}
+
+/********************************************************************************
+* sysclock_cancel_alarm: Avbryter eventuellt inställt alarm.
+********************************************************************************/
+void sysclock_cancel_alarm(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   alarm_armed = false;
+   TIMSK1 &= ~(1 << OCIE1A);
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* sysclock_alarm_armed: Indikerar ifall ett alarm är inställt och ännu inte
+*                       har löst ut.
+********************************************************************************/
+bool sysclock_alarm_armed(void)
+{
+   return alarm_armed;
+}
+
+/********************************************************************************
+* ISR (TIMER1_OVF_vect): Avbrottsrutin som äger rum vid overflow av Timer 1,
+*                        vilket sker var 32.768:e millisekund med prescaler 8
+*                        (var 4.096:e millisekund med prescaler 1). Tidsbasen
+*                        räknas upp med motsvarande tid, där sekvensnumret
+*                        räknas upp så att pågående avläsningar i
+*                        huvudprogrammet upptäcker uppdateringen.
+*
+*                        Ifall ett alarm ska lösa ut i det overflow-intervall
+*                        som nu påbörjas aktiveras compare-avbrott. Ligger
+*                        alarmet så nära overflow att compare-värdet redan
+*                        kan ha passerats anses alarmet ha löst ut direkt,
+*                        eftersom detta avbrott i sig väcker processorn.
+********************************************************************************/
+ISR (TIMER1_OVF_vect)
+{
+   ISR_PROBE_ENTER(TCNT1);
+   sequence++;
+   overflows++;
+   millis += SYSCLOCK_OVERFLOW_MS;
+   micros_rest += SYSCLOCK_OVERFLOW_US;
+
+   if (micros_rest >= 1000)
+   {
+      micros_rest -= 1000;
+      millis++;
+   }
+
+   if (alarm_armed && alarm_overflow == overflows)
+   {
+      if (OCR1A < SYSCLOCK_ALARM_MARGIN)
+      {
+         alarm_armed = false;
+      }
+      else
+      {
+         TIFR1 = (1 << OCF1A);
+         TIMSK1 |= (1 << OCIE1A);
+      }
+   }
+   ISR_PROBE_EXIT(ISR_PROBE_TIMER1_OVF);
+   return;
+}
+
+/********************************************************************************
+* ISR (TIMER1_COMPA_vect): Avbrottsrutin som äger rum när inställt alarm löser
+*                          ut. Compare-avbrott inaktiveras, då avbrottet i sig
+*                          räcker för att väcka processorn.
+********************************************************************************/
+ISR (TIMER1_COMPA_vect)
+{
+   ISR_PROBE_ENTER(TCNT1 - OCR1A);
+   TIMSK1 &= ~(1 << OCIE1A);
+   alarm_armed = false;
+   ISR_PROBE_EXIT(ISR_PROBE_TIMER1_COMPA);
+   return;
+}
+
+/********************************************************************************
+* sysclock_read: Läser av tidsbasen utan att inaktivera avbrott. Sekvensnumret
+*                läses före och efter avläsningen. Om ett overflow-avbrott har
+*                ägt rum under avläsningen skiljer sig sekvensnumren åt,
+*                varvid avläsningen görs om. Sekvensnumret är 8 bitar och
+*                läses därmed alltid i en instruktion.
+*
+*                Ifall funktionen anropas med avbrott inaktiverade (exempelvis
+*                från en avbrottsrutin) kan ett overflow ha skett utan att
+*                motsvarande avbrottsrutin har exekverats. Detta upptäcks via
+*                flaggan TOV1 tillsammans med ett lågt värde i TCNT1 och
+*                kompenseras, så att avläst tid aldrig minskar.
+*
+*                Endast avläsningen av TCNT1 sker med avbrott inaktiverade,
+*                se sysclock_read_count.
+*
+*                - snapshot: Pekare till struktur där avläsningen lagras.
+********************************************************************************/
+static void sysclock_read(struct sysclock_snapshot* snapshot)
+{
+   uint8_t start;
+
+   do
+   {
+      start = sequence;
+      snapshot->millis = millis;
+      snapshot->micros = micros_rest;
+      snapshot->overflows = overflows;
+
+      snapshot->count = sysclock_read_count();
+
+      if ((TIFR1 & (1 << TOV1)) && snapshot->count < 0x8000)
+      {
+         snapshot->millis += SYSCLOCK_OVERFLOW_MS;
+         snapshot->micros += SYSCLOCK_OVERFLOW_US;
+         snapshot->overflows++;
+      }
+   } while (start != sequence);
+
+   snapshot->micros += snapshot->count / SYSCLOCK_COUNTS_PER_US;
+   return;
+}
+
+/********************************************************************************
+* sysclock_read_count: Läser av TCNT1 med avbrott inaktiverade. Timer 1:s
+*                      16-bitars register läses via det delade registret
+*                      TEMP, där läsning av den låga byten kopierar den höga
+*                      byten till TEMP. Avbrottsrutiner som läser TCNT1 eller
+*                      ICR1 (se isr_probe.h samt icp.h) skulle annars kunna
+*                      skriva över TEMP mellan läsningen av den låga och den
+*                      höga byten, varvid den höga byten blir fel. Avläsning
+*                      från avbrottsrutiner, där avbrott redan är
+*                      inaktiverade, behöver inget sådant skydd.
+********************************************************************************/
+static inline uint16_t sysclock_read_count(void)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+   const uint16_t count = TCNT1;
+   SREG = sreg;
+   return count;
+}
\ No newline at end of file
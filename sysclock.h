@@ -0,0 +1,134 @@
+/********************************************************************************
+* sysclock.h: Innehåller drivrutiner för systemets tidsbas, som implementeras
+*             via den 16-bitars timerkretsen Timer 1. Timern löper fritt med
+*             prescaler SYSCLOCK_PRESCALER i Normal Mode. Som default används
+*             prescaler 8, vilket ger 2 MHz (upplösning 0,5 us) och overflow
+*             var 32.768:e millisekund, där antalet passerade millisekunder
+*             räknas upp i motsvarande avbrottsrutin. Overflow-avbrottet
+*             väcker därmed processorn cirka 30,5 gånger per sekund även när
+*             inga timers är aktiverade, jämfört med cirka 244 gånger per
+*             sekund med prescaler 1.
+*
+*             Prescaler 1 (16 MHz, overflow var 4.096:e millisekund) kan
+*             väljas via kompilatorflaggan -DSYSCLOCK_PRESCALER=1 och används
+*             som default när avbrottsrutiner instrumenteras via isr_probe.h
+*             (-DISR_PROBE_ENABLED=1), så att de mäts på klockcykeln.
+*
+*             Via compare-enheten A kan ett alarm ställas in på godtycklig
+*             tidpunkt framåt i tiden. Alarm längre bort än ett overflow
+*             kedjas via overflow-avbrotten, där compare-avbrottet aktiveras
+*             först i det overflow-intervall då alarmet ska lösa ut.
+*
+*             Tiden kan läsas av som millisekunder, mikrosekunder eller
+*             klockcykler, exempelvis för tidsstämplar, latensmätning samt
+*             timeouts. Avläsning sker utan att avbrott inaktiveras: ett
+*             sekvensnummer som räknas upp i overflow-avbrottet läses före
+*             och efter avläsningen, som görs om ifall det har ändrats.
+*
+*             Timer 1 samt avbrottsvektorer TIMER1_OVF_vect och
+*             TIMER1_COMPA_vect är därmed reserverade för tidsbasen.
+*             Övriga delar av Timer 1, såsom input capture (se icp.h), kan
+*             nyttja tidsbasen så länge timerns klocka samt mode lämnas orörda.
+********************************************************************************/
+#ifndef SYSCLOCK_H_
+#define SYSCLOCK_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+
+/* Makrodefinitioner: */
+#ifndef SYSCLOCK_PRESCALER
+#if defined(ISR_PROBE_ENABLED) && ISR_PROBE_ENABLED
+#define SYSCLOCK_PRESCALER 1 /* Cykelexakta tidsstämplar vid instrumentering, se isr_probe.h. */
+#else
+#define SYSCLOCK_PRESCALER 8 /* Prescaler för Timer 1 (1 eller 8). */
+#endif
+#endif
+
+#if SYSCLOCK_PRESCALER != 1 && SYSCLOCK_PRESCALER != 8
+#error "SYSCLOCK_PRESCALER must be 1 or 8!"
+#endif
+
+#define SYSCLOCK_COUNTS_PER_US (F_CPU / 1000000UL / SYSCLOCK_PRESCALER) /* Räknarsteg per mikrosekund. */
+
+/********************************************************************************
+* sysclock_init: Initierar tidsbasen, som startar från noll. Timer 1 sätts i
+*                Normal Mode med prescaler SYSCLOCK_PRESCALER och
+*                overflow-avbrott aktiveras.
+********************************************************************************/
+void sysclock_init(void);
+
+/********************************************************************************
+* sysclock_millis: Returnerar antalet millisekunder som har passerat sedan
+*                  tidsbasen initierades.
+********************************************************************************/
+uint32_t sysclock_millis(void);
+
+/********************************************************************************
+* sysclock_micros: Returnerar antalet mikrosekunder som har passerat sedan
+*                  tidsbasen initierades. Värdet slår runt efter cirka 71
+*                  minuter, vilket hanteras genom att alltid beräkna
+*                  skillnaden mellan två avläsningar.
+********************************************************************************/
+uint32_t sysclock_micros(void);
+
+/********************************************************************************
+* sysclock_cycles: Returnerar antalet klockcykler (1 / 16 us) som har passerat
+*                  sedan tidsbasen initierades. Värdet slår runt efter cirka
+*                  268 sekunder och lämpar sig för mätning av korta förlopp.
+*                  Upplösningen är SYSCLOCK_PRESCALER klockcykler.
+********************************************************************************/
+uint32_t sysclock_cycles(void);
+
+/********************************************************************************
+* sysclock_extend: Utökar ett 16-bitars räknarvärde från Timer 1, exempelvis
+*                  ett värde fångat i ICR1, till 32 bitar i samma format som
+*                  sysclock_cycles. Funktionen ska anropas med avbrott
+*                  inaktiverade, exempelvis från en avbrottsrutin, inom ett
+*                  halvt overflow-intervall (16 ms med prescaler 8, 2 ms med
+*                  prescaler 1) från att värdet fångades.
+*
+*                  - count: Räknarvärdet som ska utökas.
+********************************************************************************/
+uint32_t sysclock_extend(const uint16_t count);
+
+/********************************************************************************
+* sysclock_timeout: Indikerar ifall angiven tid har passerat sedan angiven
+*                   starttidpunkt. Jämförelsen görs via skillnaden mellan
+*                   tidpunkterna och fungerar därmed även när tidsbasen
+*                   har slagit runt.
+*
+*                   - start_ms  : Starttidpunkten mätt i millisekunder.
+*                   - timeout_ms: Tiden som ska ha passerat i millisekunder.
+********************************************************************************/
+static inline bool sysclock_timeout(const uint32_t start_ms,
+                                    const uint32_t timeout_ms)
+{
+   return sysclock_millis() - start_ms >= timeout_ms;
+}
+
+/********************************************************************************
+* sysclock_set_alarm: Ställer in ett alarm, som löser ut via compare-avbrott när
+*                     angiven tidpunkt mätt i millisekunder uppnås. Ett
+*                     tidigare inställt alarm ersätts. Alarmet medför endast
+*                     att processorn väcks ur eventuellt sleep mode. Ifall
+*                     angiven tidpunkt redan har passerats ställs inget alarm
+*                     in och false returneras, annars returneras true.
+*
+*                     - wake_ms: Tidpunkten då alarmet ska lösa ut, mätt i
+*                                millisekunder sedan initieringen.
+********************************************************************************/
+bool sysclock_set_alarm(const uint32_t wake_ms);
+
+/********************************************************************************
+* sysclock_cancel_alarm: Avbryter eventuellt inställt alarm.
+********************************************************************************/
+void sysclock_cancel_alarm(void);
+
+/********************************************************************************
+* sysclock_alarm_armed: Indikerar ifall ett alarm är inställt och ännu inte
+*                       har löst ut.
+********************************************************************************/
+bool sysclock_alarm_armed(void);
+
+#endif /* SYSCLOCK_H_ */
\ No newline at end of file
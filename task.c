@@ -0,0 +1,267 @@
+/********************************************************************************
+* task.c: Innehåller definitioner av associerade funktioner för strukten task
+*         samt schemaläggaren som kör samtliga tasks.
+********************************************************************************/
+#include "task.h"
+#include "sysclock.h"
+#include "serial.h"
+
+/* Statiska variabler: */
+static struct task* first = 0; /* Första tasken i schemaläggaren (högst prioritet). */
+
+/* Statiska funktioner: */
+static void task_timer_callback(void* arg);
+static bool task_is_ready(const struct task* self);
+static void task_poll_conditions(void);
+static void task_execute(struct task* self);
+
+/********************************************************************************
+* task_scheduler_init: Initierar schemaläggaren utan några tasks och
+*                      registrerar funktionen task_pending hos timerhjulet.
+********************************************************************************/
+void task_scheduler_init(void)
+{
+   first = 0;
+   soft_timer_set_pending_check(task_pending);
+   return;
+}
+
+/********************************************************************************
+* task_init: Initierar ny task med angiven taskfunktion.
+*
+*            - self    : Pekare till tasken som ska initieras.
+*            - name    : Taskens namn.
+*            - function: Taskfunktion som anropas när tasken körs.
+*            - arg     : Argument som skickas till taskfunktionen.
+********************************************************************************/
+void task_init(struct task* self,
+               const char* name,
+               void (*function)(void* arg),
+               void* arg)
+{
+   self->next = 0;
+   self->name = name;
+   self->function = function;
+   self->arg = arg;
+   self->condition = 0;
+   self->ready = false;
+   self->ready_us = 0;
+   soft_timer_init(&self->timer, task_timer_callback, self);
+   task_reset_stats(self);
+   return;
+}
+
+/********************************************************************************
+* task_set_period: Sätter periodtid för angiven task via taskens mjukvarutimer.
+*                  Missade perioder slås ihop, eftersom en task som redan är
+*                  redo inte kan bli mer redo.
+*
+*                  - self     : Pekare till tasken vars periodtid ska sättas.
+*                  - period_ms: Periodtiden mätt i millisekunder.
+********************************************************************************/
+void task_set_period(struct task* self,
+                     const uint32_t period_ms)
+{
+   if (period_ms)
+   {
+      soft_timer_set_coalesce(&self->timer, true);
+      soft_timer_start_periodic(&self->timer, period_ms);
+   }
+   else
+   {
+      soft_timer_stop(&self->timer);
+   }
+   return;
+}
+
+/********************************************************************************
+* task_signal: Markerar angiven task som redo att köras. Ifall tasken redan
+*              är redo behålls den tidigare tidpunkten, så att uppmätt latens
+*              räknas från första signalen. Avbrott inaktiveras tillfälligt,
+*              eftersom tidpunkten är 32 bitar.
+*
+*              - self: Pekare till tasken som ska signaleras.
+********************************************************************************/
+void task_signal(struct task* self)
+{
+   const uint8_t sreg = SREG;
+   asm("CLI");
+
+   if (!self->ready)
+   {
+      self->ready_us = sysclock_micros();
+      self->ready = true;
+   }
+
+   SREG = sreg;
+   return;
+}
+
+/********************************************************************************
+* task_add: Lägger till angiven task sist i schemaläggaren.
+*
+*           - self: Pekare till tasken som ska läggas till.
+********************************************************************************/
+void task_add(struct task* self)
+{
+   struct task** last = &first;
+
+   while (*last)
+   {
+      if (*last == self) return;
+      last = &(*last)->next;
+   }
+
+   self->next = 0;
+   *last = self;
+   return;
+}
+
+/********************************************************************************
+* task_reset_stats: Nollställer statistiken för angiven task.
+*
+*                   - self: Pekare till tasken vars statistik ska nollställas.
+********************************************************************************/
+void task_reset_stats(struct task* self)
+{
+   self->stats.runs = 0;
+   self->stats.run_time_avg_cycles = 0;
+   self->stats.run_time_max_cycles = 0;
+   self->stats.latency_max_us = 0;
+   return;
+}
+
+/********************************************************************************
+* task_run: Hanterar utgångna mjukvarutimers, vilket gör periodiska tasks
+*           redo, och signalerar tasks vars väckningsvillkor är uppfyllt,
+*           följt av att samtliga redo tasks körs en gång var. Tasks som
+*           blir redo under tiden körs vid nästa anrop, vilket sker direkt
+*           eftersom soft_timer_sleep då inte försätter processorn i sleep
+*           mode.
+********************************************************************************/
+void task_run(void)
+{
+   soft_timer_run();
+   task_poll_conditions();
+
+   for (struct task* self = first; self; self = self->next)
+   {
+      if (self->ready)
+      {
+         task_execute(self);
+      }
+   }
+   return;
+}
+
+/********************************************************************************
+* task_pending: Indikerar ifall någon task är redo att köras, antingen via
+*               signal eller via sitt väckningsvillkor.
+********************************************************************************/
+bool task_pending(void)
+{
+   for (const struct task* self = first; self; self = self->next)
+   {
+      if (task_is_ready(self)) return true;
+   }
+   return false;
+}
+
+/********************************************************************************
+* task_print_stats: Skriver ut statistik för samtliga tasks via seriell
+*                   överföring. Körtider skrivs ut i klockcykler (1 / 16 us)
+*                   och latens i mikrosekunder.
+********************************************************************************/
+void task_print_stats(void)
+{
+   for (const struct task* self = first; self; self = self->next)
+   {
+      serial_print_string(self->name);
+      SERIAL_PRINT_P(": runs ");
+      serial_print_unsigned(self->stats.runs);
+      SERIAL_PRINT_P(", avg ");
+      serial_print_unsigned(self->stats.run_time_avg_cycles);
+      SERIAL_PRINT_P(" cycles, max ");
+      serial_print_unsigned(self->stats.run_time_max_cycles);
+      SERIAL_PRINT_P(" cycles, max latency ");
+      serial_print_unsigned(self->stats.latency_max_us);
+      SERIAL_PRINT_P(" us\n");
+   }
+   return;
+}
+
+/********************************************************************************
+* task_timer_callback: Callbackrutin för taskens mjukvarutimer, som gör
+*                      tasken redo att köras.
+*
+*                      - arg: Pekare till tasken vars timer har löpt ut.
+********************************************************************************/
+static void task_timer_callback(void* arg)
+{
+   task_signal((struct task*)arg);
+   return;
+}
+
+/********************************************************************************
+* task_is_ready: Indikerar ifall angiven task är redo att köras.
+*
+*                - self: Pekare till tasken som ska kontrolleras.
+********************************************************************************/
+static bool task_is_ready(const struct task* self)
+{
+   return self->ready || (self->condition && self->condition());
+}
+
+/********************************************************************************
+* task_poll_conditions: Signalerar samtliga tasks vars väckningsvillkor är
+*                       uppfyllt. Tidpunkten då villkoret först observeras
+*                       lagras därmed på samma sätt som vid en signal, så att
+*                       latensen även omfattar tiden som tasken väntar på
+*                       tasks med högre prioritet.
+********************************************************************************/
+static void task_poll_conditions(void)
+{
+   for (struct task* self = first; self; self = self->next)
+   {
+      if (!self->ready && self->condition && self->condition())
+      {
+         task_signal(self);
+      }
+   }
+   return;
+}
+
+/********************************************************************************
+* task_execute: Kör angiven task och uppdaterar dess statistik. Redo-flaggan
+*               nollställs före anropet, så att en signal under körningen
+*               medför att tasken körs igen. Latensen räknas från signalen,
+*               eller från att väckningsvillkoret först observerades.
+*
+*               - self: Pekare till tasken som ska köras.
+********************************************************************************/
+static void task_execute(struct task* self)
+{
+   struct task_stats* stats = &self->stats;
+
+   asm("CLI");
+   const uint32_t latency_us = sysclock_micros() - self->ready_us;
+   self->ready = false;
+   asm("SEI");
+
+   const uint32_t start = sysclock_cycles();
+   self->function(self->arg);
+   const uint32_t run_time = sysclock_cycles() - start;
+
+   if (latency_us > stats->latency_max_us) stats->latency_max_us = latency_us;
+   if (run_time > stats->run_time_max_cycles) stats->run_time_max_cycles = run_time;
+
+   if (stats->runs++ == 0)
+   {
+      stats->run_time_avg_cycles = run_time;
+   }
+   else
+   {
+      stats->run_time_avg_cycles += ((int32_t)(run_time - stats->run_time_avg_cycles)) / 16;
+   }
+   return;
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/********************************************************************************
+* task.h: Innehåller en kooperativ schemaläggare för huvudloopen via strukten
+*         task samt associerade funktioner. Varje task utgörs av en
+*         taskfunktion, som körs till slut vid varje anrop, varför samtliga
+*         tasks delar på en och samma stack.
+*
+*         En task blir redo att köras av något av följande villkor:
+*
+*         1. Periodiskt med angiven periodtid, implementerat via en
+*            mjukvarutimer (se soft_timer.h).
+*
+*         2. Via anrop av funktionen task_signal, exempelvis från en
+*            avbrottsrutin.
+*
+*         3. Via ett väckningsvillkor i form av en funktion, som returnerar
+*            true när tasken har arbete att utföra, exempelvis event_pending.
+*
+*         Redo tasks körs i den ordning de har lagts till i schemaläggaren,
+*         vilket därmed utgör deras prioritet. För varje task mäts körtiden
+*         i klockcykler samt latensen från att tasken blev redo tills den
+*         startades i mikrosekunder via tidsbasen i sysclock, vilket visar
+*         hur mycket marginal som finns kvar.
+*
+*         Exempel på användning:
+*
+*         int main(void)
+*         {
+*            soft_timer_wheel_init_tickless();
+*            task_scheduler_init();
+*
+*            task_init(&blink_task, "blink", blink, &l1);
+*            task_set_period(&blink_task, 50);
+*            task_add(&blink_task);
+*
+*            while (1)
+*            {
+*               task_run();
+*               soft_timer_sleep();
+*            }
+*         }
+********************************************************************************/
+#ifndef TASK_H_
+#define TASK_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+#include "soft_timer.h"
+
+/********************************************************************************
+* task_stats: Strukt för lagring av statistik för en task.
+********************************************************************************/
+struct task_stats
+{
+   uint32_t runs;                /* Antal körningar av tasken. */
+   uint32_t run_time_avg_cycles; /* Glidande medelvärde av körtiden (1/16 per körning). */
+   uint32_t run_time_max_cycles; /* Längsta körtid mätt i klockcykler. */
+   uint32_t latency_max_us;      /* Längsta tid från redo till start i mikrosekunder. */
+};
+
+/********************************************************************************
+* task: Strukt för implementering av tasks, som körs kooperativt i huvudloopen
+*       när de är redo att köras.
+********************************************************************************/
+struct task
+{
+   struct task* next;            /* Pekare till nästa task i schemaläggaren. */
+   const char* name;             /* Taskens namn, används vid utskrift av statistik. */
+   void (*function)(void* arg);  /* Taskfunktion som anropas när tasken körs. */
+   void* arg;                    /* Argument som skickas till taskfunktionen. */
+   bool (*condition)(void);      /* Väckningsvillkor (0 om inget villkor används). */
+   struct soft_timer timer;      /* Mjukvarutimer för periodisk körning. */
+   volatile bool ready;          /* Indikerar ifall tasken är redo att köras. */
+   volatile uint32_t ready_us;   /* Tidpunkt då tasken blev redo i mikrosekunder. */
+   struct task_stats stats;      /* Statistik över körtid samt latens. */
+};
+
+/********************************************************************************
+* task_scheduler_init: Initierar schemaläggaren utan några tasks. Tidsbasen i
+*                      sysclock används för mätning och måste vara initierad,
+*                      exempelvis via soft_timer_wheel_init_tickless.
+*                      Schemaläggaren registreras även hos timerhjulet, så
+*                      att soft_timer_sleep inte försätter processorn i sleep
+*                      mode så länge någon task är redo att köras.
+********************************************************************************/
+void task_scheduler_init(void);
+
+/********************************************************************************
+* task_init: Initierar ny task med angiven taskfunktion. Tasken saknar
+*            väckningsvillkor tills periodtid eller villkor har angetts och
+*            körs först efter att den har lagts till i schemaläggaren.
+*
+*            - self    : Pekare till tasken som ska initieras.
+*            - name    : Taskens namn.
+*            - function: Taskfunktion som anropas när tasken körs.
+*            - arg     : Argument som skickas till taskfunktionen.
+********************************************************************************/
+void task_init(struct task* self,
+               const char* name,
+               void (*function)(void* arg),
+               void* arg);
+
+/********************************************************************************
+* task_set_period: Sätter periodtid för angiven task, som därmed blir redo
+*                  att köras med angiven periodtid. Periodtiden 0 stoppar
+*                  periodisk körning.
+*
+*                  - self     : Pekare till tasken vars periodtid ska sättas.
+*                  - period_ms: Periodtiden mätt i millisekunder.
+********************************************************************************/
+void task_set_period(struct task* self,
+                     const uint32_t period_ms);
+
+/********************************************************************************
+* task_set_condition: Sätter väckningsvillkor för angiven task. Villkoret
+*                     kontrolleras i varje varv av huvudloopen samt inför
+*                     sleep och ska därmed gå snabbt att utvärdera.
+*
+*                     - self     : Pekare till tasken vars villkor ska sättas.
+*                     - condition: Funktion som returnerar true när tasken
+*                                  ska köras (0 för att ta bort villkoret).
+********************************************************************************/
+static inline void task_set_condition(struct task* self,
+                                      bool (*condition)(void))
+{
+   self->condition = condition;
+   return;
+}
+
+/********************************************************************************
+* task_signal: Markerar angiven task som redo att köras, där tidpunkten
+*              lagras för mätning av latens. Funktionen kan anropas både
+*              från huvudloopen och från avbrottsrutiner.
+*
+*              - self: Pekare till tasken som ska signaleras.
+********************************************************************************/
+void task_signal(struct task* self);
+
+/********************************************************************************
+* task_add: Lägger till angiven task sist i schemaläggaren, vilket medför
+*           lägst prioritet av samtliga tillagda tasks.
+*
+*           - self: Pekare till tasken som ska läggas till.
+********************************************************************************/
+void task_add(struct task* self);
+
+/********************************************************************************
+* task_reset_stats: Nollställer statistiken för angiven task.
+*
+*                   - self: Pekare till tasken vars statistik ska nollställas.
+********************************************************************************/
+void task_reset_stats(struct task* self);
+
+/********************************************************************************
+* task_run: Hanterar utgångna mjukvarutimers, följt av att samtliga tasks som
+*           är redo körs en gång var i prioritetsordning. Funktionen ska
+*           anropas kontinuerligt från huvudloopen.
+********************************************************************************/
+void task_run(void);
+
+/********************************************************************************
+* task_pending: Indikerar ifall någon task är redo att köras.
+********************************************************************************/
+bool task_pending(void);
+
+/********************************************************************************
+* task_print_stats: Skriver ut statistik för samtliga tasks i schemaläggaren
+*                   via seriell överföring, en rad per task.
+********************************************************************************/
+void task_print_stats(void);
+
+#endif /* TASK_H_ */
\ No newline at end of file
@@ -0,0 +1,169 @@
+/********************************************************************************
+* telemetry.c: Innehåller funktionsdefinitioner för binär telemetri via
+*              seriell överföring.
+********************************************************************************/
+#include "telemetry.h"
+#include "sysclock.h"
+#include "frame.h"
+
+/* Makrodefinitioner: */
+#define TELEMETRY_HEADER_SIZE 5  /* Sekvensnummer (1) samt bastid (4). */
+#define TELEMETRY_TYPE_SHIFT 6   /* Bitposition för datatypen i postens första byte. */
+
+/* Statiska variabler: */
+static uint8_t frame[TELEMETRY_FRAME_SIZE]; /* Ram under uppbyggnad. */
+static uint8_t frame_length = 0; /* Antal byte i ramen. */
+static uint8_t sequence = 0;     /* Sekvensnummer för nästa ram. */
+static uint32_t base_us = 0;     /* Bastid för ramen i mikrosekunder. */
+
+/* Statiska funktioner: */
+static void telemetry_add(const uint8_t channel,
+                          const enum telemetry_type type,
+                          const void* value,
+                          const uint8_t size);
+static inline void telemetry_put(const void* data,
+                                 const uint8_t size);
+
+/********************************************************************************
+* telemetry_init: Initierar telemetrin med en tom ram och sekvensnummer 0.
+********************************************************************************/
+void telemetry_init(void)
+{
+   frame_length = 0;
+   sequence = 0;
+   return;
+}
+
+/********************************************************************************
+* telemetry_add_int16: Lägger till ett signerat 16-bitars mätvärde.
+*
+*                      - channel: Kanalnummer 0 - 63.
+*                      - value  : Mätvärdet.
+********************************************************************************/
+void telemetry_add_int16(const uint8_t channel,
+                         const int16_t value)
+{
+   telemetry_add(channel, TELEMETRY_TYPE_INT16, &value, sizeof(value));
+   return;
+}
+
+/********************************************************************************
+* telemetry_add_uint16: Lägger till ett osignerat 16-bitars mätvärde.
+*
+*                       - channel: Kanalnummer 0 - 63.
+*                       - value  : Mätvärdet.
+********************************************************************************/
+void telemetry_add_uint16(const uint8_t channel,
+                          const uint16_t value)
+{
+   telemetry_add(channel, TELEMETRY_TYPE_UINT16, &value, sizeof(value));
+   return;
+}
+
+/********************************************************************************
+* telemetry_add_int32: Lägger till ett signerat 32-bitars mätvärde.
+*
+*                      - channel: Kanalnummer 0 - 63.
+*                      - value  : Mätvärdet.
+********************************************************************************/
+void telemetry_add_int32(const uint8_t channel,
+                         const int32_t value)
+{
+   telemetry_add(channel, TELEMETRY_TYPE_INT32, &value, sizeof(value));
+   return;
+}
+
+/********************************************************************************
+* telemetry_add_float: Lägger till ett mätvärde i form av ett flyttal.
+*
+*                      - channel: Kanalnummer 0 - 63.
+*                      - value  : Mätvärdet.
+********************************************************************************/
+void telemetry_add_float(const uint8_t channel,
+                         const float value)
+{
+   telemetry_add(channel, TELEMETRY_TYPE_FLOAT, &value, sizeof(value));
+   return;
+}
+
+/********************************************************************************
+* telemetry_flush: Skickar aktuell ram ifall den innehåller några poster.
+*                  Ramen skickas via frame_send, som lägger till CRC-16 samt
+*                  COBS-kodar ramen.
+********************************************************************************/
+void telemetry_flush(void)
+{
+   if (frame_length <= TELEMETRY_HEADER_SIZE) return;
+   frame_send(FRAME_TYPE_TELEMETRY, frame, frame_length);
+   sequence++;
+   frame_length = 0;
+   return;
+}
+
+/********************************************************************************
+* telemetry_sequence: Returnerar sekvensnumret för nästa ram som skickas.
+********************************************************************************/
+uint8_t telemetry_sequence(void)
+{
+   return sequence;
+}
+
+/********************************************************************************
+* telemetry_add: Lägger till en post i aktuell ram. Ifall posten inte ryms i
+*                ramen, eller om tiden sedan ramens bastid inte ryms i 16
+*                bitar (cirka 65 ms), skickas ramen först. En ny ram får
+*                aktuell tid som bastid. Kanalnummer utöver 63 ignoreras.
+*
+*                - channel: Kanalnummer 0 - 63.
+*                - type   : Postens datatyp.
+*                - value  : Pekare till värdet (little endian på AVR).
+*                - size   : Värdets storlek i byte.
+********************************************************************************/
+static void telemetry_add(const uint8_t channel,
+                          const enum telemetry_type type,
+                          const void* value,
+                          const uint8_t size)
+{
+   const uint32_t now_us = sysclock_micros();
+   const uint8_t record_size = 1 + sizeof(uint16_t) + size;
+
+   if (channel > TELEMETRY_CHANNEL_MAX) return;
+
+   if (frame_length + record_size > TELEMETRY_FRAME_SIZE ||
+       (frame_length && now_us - base_us > UINT16_MAX))
+   {
+      telemetry_flush();
+   }
+
+   if (!frame_length)
+   {
+      base_us = now_us;
+      frame[frame_length++] = sequence;
+      telemetry_put(&base_us, sizeof(base_us));
+   }
+
+   const uint16_t offset_us = (uint16_t)(now_us - base_us);
+   frame[frame_length++] = ((uint8_t)type << TELEMETRY_TYPE_SHIFT) | channel;
+   telemetry_put(&offset_us, sizeof(offset_us));
+   telemetry_put(value, size);
+   return;
+}
+
+/********************************************************************************
+* telemetry_put: Kopierar angivet antal byte sist i aktuell ram. AVR lagrar
+*                flerbytesvärden little endian, varför byte kopieras i ordning.
+*
+*                - data: Pekare till data som ska kopieras.
+*                - size: Antal byte som ska kopieras.
+********************************************************************************/
+static inline void telemetry_put(const void* data,
+                                 const uint8_t size)
+{
+   const uint8_t* bytes = (const uint8_t*)data;
+
+   for (uint8_t i = 0; i < size; ++i)
+   {
+      frame[frame_length++] = bytes[i];
+   }
+   return;
+}
\ No newline at end of file
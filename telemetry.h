@@ -0,0 +1,105 @@
+/********************************************************************************
+* telemetry.h: Innehåller drivrutiner för binär telemetri via seriell
+*              överföring, avsedd för strömning av mätvärden med hög takt.
+*
+*              Mätvärden lagras som poster bestående av kanal, datatyp,
+*              tidsstämpel samt värde. Poster samlas i en ram, som skickas
+*              när den är full, när tidsstämpeln inte längre ryms eller vid
+*              anrop av telemetry_flush. Ramar skickas via frame.h med typen
+*              FRAME_TYPE_TELEMETRY, vilket innebär att CRC-16 läggs till och
+*              att ramen COBS-kodas. Ramens data är följande:
+*
+*              [sekvensnummer (1)] [bastid i us (4)] [post]...
+*
+*              där varje post består av:
+*
+*              [typ (2 bitar) | kanal (6 bitar)] [tid sedan bastid i us (2)]
+*              [värde (2 eller 4 byte beroende på typ)]
+*
+*              Samtliga fält lagras little endian. Sekvensnumret räknas upp
+*              för varje ram, så att mottagaren kan upptäcka förlorade ramar.
+*
+*              En post med ett 16-bitars värde kostar fem byte, vilket
+*              tillsammans med ramens overhead ger cirka sex byte per
+*              mätvärde, att jämföra med 20 - 30 byte vid utskrift i
+*              klartext såsom "Temperature: 23.45\n".
+*
+*              Ramar kan blandas med vanlig textutskrift på samma port och
+*              avkodas på värddatorn via host/telemetry_decode.c.
+********************************************************************************/
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+
+/* Makrodefinitioner: */
+#define TELEMETRY_FRAME_SIZE 64     /* Maximal mängd data per ram (max FRAME_DATA_SIZE_MAX). */
+#define TELEMETRY_CHANNEL_MAX 63    /* Högsta kanalnummer (6 bitar). */
+
+/********************************************************************************
+* telemetry_type: Enumeration för datatyper i telemetriposter.
+********************************************************************************/
+enum telemetry_type
+{
+   TELEMETRY_TYPE_INT16,  /* Signerat 16-bitars heltal. */
+   TELEMETRY_TYPE_UINT16, /* Osignerat 16-bitars heltal. */
+   TELEMETRY_TYPE_INT32,  /* Signerat 32-bitars heltal. */
+   TELEMETRY_TYPE_FLOAT   /* 32-bitars flyttal (IEEE 754). */
+};
+
+/********************************************************************************
+* telemetry_init: Initierar telemetrin med en tom ram och sekvensnummer 0.
+*                 Tidsbasen i sysclock samt seriell överföring måste vara
+*                 initierade.
+********************************************************************************/
+void telemetry_init(void);
+
+/********************************************************************************
+* telemetry_add_int16: Lägger till ett signerat 16-bitars mätvärde.
+*
+*                      - channel: Kanalnummer 0 - 63.
+*                      - value  : Mätvärdet.
+********************************************************************************/
+void telemetry_add_int16(const uint8_t channel,
+                         const int16_t value);
+
+/********************************************************************************
+* telemetry_add_uint16: Lägger till ett osignerat 16-bitars mätvärde,
+*                       exempelvis ett resultat från AD-omvandlaren.
+*
+*                       - channel: Kanalnummer 0 - 63.
+*                       - value  : Mätvärdet.
+********************************************************************************/
+void telemetry_add_uint16(const uint8_t channel,
+                          const uint16_t value);
+
+/********************************************************************************
+* telemetry_add_int32: Lägger till ett signerat 32-bitars mätvärde.
+*
+*                      - channel: Kanalnummer 0 - 63.
+*                      - value  : Mätvärdet.
+********************************************************************************/
+void telemetry_add_int32(const uint8_t channel,
+                         const int32_t value);
+
+/********************************************************************************
+* telemetry_add_float: Lägger till ett mätvärde i form av ett flyttal.
+*
+*                      - channel: Kanalnummer 0 - 63.
+*                      - value  : Mätvärdet.
+********************************************************************************/
+void telemetry_add_float(const uint8_t channel,
+                         const float value);
+
+/********************************************************************************
+* telemetry_flush: Skickar aktuell ram ifall den innehåller några poster.
+********************************************************************************/
+void telemetry_flush(void);
+
+/********************************************************************************
+* telemetry_sequence: Returnerar sekvensnumret för nästa ram som skickas.
+********************************************************************************/
+uint8_t telemetry_sequence(void);
+
+#endif /* TELEMETRY_H_ */
\ No newline at end of file
@@ -1,190 +1,376 @@
-/********************************************************************************
-* timer.c: Innehller definitioner av associerade funktioner fr strukten timer.
-********************************************************************************/
-#include "timer.h"
-
-/* Makrodefinitioner: */
-#define TIME_BETWEEN_INTERRUPTS_MS 0.128 /* Tid mellan varje timergenererat avbrott. */
-
-/* Statiska funktioner: */
-static void timer_init_circuit(struct timer* self);
-static void timer_disable_circuit(struct timer* self);
-static inline uint32_t timer_get_max_count(const double time_ms);
-
-/********************************************************************************
-* timer_init: Initierar ny timerkrets med angiven tid mtt i millisekunder.
-*             Om timern ska anvndas som rknare fr att rkna upp till ett
-*             specifikt maxvrde br funktionen timer_set_max_count anropas
-*             direkt efter initieringen.
-*
-*             - self     : Pekare till timern som ska initieras.
-*             - timer_sel: Val av timerkrets.
-*             - time_ms  : Tiden timern ska sttas p mtt i millisekunder.
-********************************************************************************/
-void timer_init(struct timer* self, 
-                const enum timer_sel timer_sel, 
-                const double time_ms)
-{
-   self->counter = 0;
-   self->max_count = timer_get_max_count(time_ms);
-   self->timer_sel = timer_sel;
-   timer_init_circuit(self);
-   return;
-}
-
-/********************************************************************************
-* timer_clear: Genomfr total nollstllning av angiven timerkrets.
-*
-*              - self: Pekare till timern som ska nollstllas.
-********************************************************************************/
-void timer_clear(struct timer* self)
-{
-   timer_disable_circuit(self);
-   self->counter = 0;
-   self->max_count = 0;
-   self->timsk = 0;
-   self->timsk_bit = 0;
-   self->timer_sel = TIMER_SEL_NONE;
-   return;
-}
-
-/********************************************************************************
-* timer_toggle_interrupt: Togglar aktivering av timergenererat avbrott p
-*                         angiven timer. Om avbrott r aktiverat vid anrop sker 
-*                         inaktivering. P samma stt gller att om avbrott r 
-*                         inaktiverat vid anrop s sker aktivering.
-*
-*                         - self: Pekare till timern som aktivering av
-*                                 timergenererat avbrott ska togglas p.
-********************************************************************************/
-void timer_toggle_interrupt(struct timer* self)
-{
-   if (timer_interrupt_enabled(self))
-   {
-      timer_disable_interrupt(self);
-   }
-   else
-   {
-      timer_enable_interrupt(self);
-   }
-   return;
-}
-
-/********************************************************************************
-* timer_elapsed: Indikerar ifall angiven timer har lpt ut genom att returnera
-*                true eller false. Ifall timern har lpt ut nollstlls rknaren
-*                infr nsta upprkning.
-*
-*                - self: Pekare till timern som ska kontrolleras.
-********************************************************************************/
-bool timer_elapsed(struct timer* self)
-{
-   if (self->counter >= self->max_count)
-   {
-     self->counter = 0;
-     return true;
-   }
-   else
-   {
-      return false;
-   }
-}
-
-/********************************************************************************
-* timer_reset: terstller angiven timer till startlget.
-*
-               - self: Pekare till timern som ska terstllas.
-********************************************************************************/
-void timer_reset(struct timer* self)
-{
-   timer_disable_interrupt(self);
-   self->counter = 0;
-   return;
-}
-
-/********************************************************************************
-* timer_set_new_time: Stter ny tid p angiven timerkrets mtt i millisekunder.
-* 
-*                     - self   : Pekare till timern vars tid ska uppdateras.
-*                     - time_ms: Tiden timern ska sttas p i millisekunder.
-********************************************************************************/
-void timer_set_new_time(struct timer* self, 
-                        const double time_ms)
-{
-   self->max_count = timer_get_max_count(time_ms);
-   return;
-}
-
-/********************************************************************************
-* timer_init_circuit: Initierar angiven timerkrets. Timer 0 samt Timer 2
-*                     initieras i Normal Mode, medan Timer 1 initieras i
-*                     CTC Mode med upprkning till 256. Vid aktiverat avbrott
-*                     p godtycklig initierad timer sker timergenererat avbrott 
-*                     var 0.128:e millisekund. Adresserna till motsvarande
-*                     maskregister som bit fr aktivering av avbrott sparas.
-*
-*                     - self     : Pekare till timerkretsen som ska initieras.
-********************************************************************************/
-static void timer_init_circuit(struct timer* self)
-{
-   if (self->timer_sel == TIMER_SEL_0)
-   {
-      TCCR0B = (1 << CS01);
-      self->timsk = &TIMSK0;
-      self->timsk_bit = TOIE0;
-   }
-   else if (self->timer_sel == TIMER_SEL_1)
-   {
-      TCCR1B = (1 << CS11) | (1 << WGM12);
-      OCR1A = 256;
-      self->timsk = &TIMSK1;
-      self->timsk_bit = OCIE1A;
-   }
-   else if (self->timer_sel == TIMER_SEL_2)
-   {
-      TCCR2B = (1 << CS21);
-      self->timsk = &TIMSK2;
-      self->timsk_bit = TOIE2;
-   }
-
-   asm("SEI");
-   return;
-}
-
-/********************************************************************************
-* timer_disable_circuit: Inaktiverar angiven timerkrets s att varken upprkning
-*                        eller avbrott kan ske. 
-*
-*                        - self: Pekare till timern som ska inaktiveras.  
-********************************************************************************/
-static void timer_disable_circuit(struct timer* self)
-{
-   if (self->timer_sel == TIMER_SEL_0)
-   {
-      TCCR0B = 0x00;
-      TIMSK0 = 0x00;
-   }
-   else if (self->timer_sel == TIMER_SEL_1)
-   {
-      TCCR1B = 0x00;
-      TIMSK1 = 0x00;
-      OCR1A = 0x00;
-   }
-   else if (self->timer_sel == TIMER_SEL_2)
-   {
-      TCCR2B = 0x00;
-      TIMSK2 = 0x00;
-   }
-   return;
-}
-
-/********************************************************************************
-* timer_get_max_count: Returnerar antalet timergenererade avbrott som krvs
-*                      fr angiven tid, avrundad till nrmaste heltal.
-*
-*                      - time_ms: nskad tid mtt i millisekunder.
-********************************************************************************/
-static inline uint32_t timer_get_max_count(const double time_ms)
-{
-   return (uint32_t)(time_ms / TIME_BETWEEN_INTERRUPTS_MS + 0.5);
+/********************************************************************************
+* timer.c: Innehåller definitioner av associerade funktioner för strukten timer.
+********************************************************************************/
+#include "timer.h"
+
+/********************************************************************************
+* timer_prescaler: Strukt för lagring av en prescaler samt motsvarande bitar
+*                  CSn2 - CSn0 i timerkretsens kontrollregister TCCRnB.
+********************************************************************************/
+struct timer_prescaler
+{
+   uint16_t division; /* Prescalerns delningstal. */
+   uint8_t bits;      /* Motsvarande bitar CSn2 - CSn0. */
+};
+
+/* Tillgängliga prescalers för Timer 0: */
+static const struct timer_prescaler timer0_prescalers[] =
+{
+   { 1, (1 << CS00) },
+   { 8, (1 << CS01) },
+   { 64, (1 << CS01) | (1 << CS00) },
+   { 256, (1 << CS02) },
+   { 1024, (1 << CS02) | (1 << CS00) }
+};
+
+/* Tillgängliga prescalers för Timer 2: */
+static const struct timer_prescaler timer2_prescalers[] =
+{
+   { 1, (1 << CS20) },
+   { 8, (1 << CS21) },
+   { 32, (1 << CS21) | (1 << CS20) },
+   { 64, (1 << CS22) },
+   { 128, (1 << CS22) | (1 << CS20) },
+   { 256, (1 << CS22) | (1 << CS21) },
+   { 1024, (1 << CS22) | (1 << CS21) | (1 << CS20) }
+};
+
+/* Statiska funktioner: */
+static void timer_init_circuit(struct timer* self);
+static void timer_disable_circuit(struct timer* self);
+static void timer_write_compare(const struct timer* self);
+static void timer_set_period(struct timer* self,
+                             const uint32_t cycles);
+static inline uint32_t timer_get_cycles(const double time_ms);
+static inline uint32_t timer_get_cycles_ms(const uint32_t time_ms);
+
+/********************************************************************************
+* timer_init: Initierar ny timerkrets med angiven tid mätt i millisekunder.
+*             Om timern ska användas som räknare för att räkna upp till ett
+*             specifikt maxvärde bör funktionen timer_set_max_count anropas
+*             direkt efter initieringen. Prescaler samt compare-värde väljs
+*             utefter angiven tid, så att varje period kostar så få
+*             timergenererade avbrott som möjligt.
+*
+*             - self     : Pekare till timern som ska initieras.
+*             - timer_sel: Val av timerkrets.
+*             - time_ms  : Tiden timern ska sättas på mätt i millisekunder.
+********************************************************************************/
+void timer_init(struct timer* self, 
+                const enum timer_sel timer_sel, 
+                const double time_ms)
+{
+   self->counter = 0;
+   self->timer_sel = timer_sel;
+   timer_set_period(self, timer_get_cycles(time_ms));
+   timer_init_circuit(self);
+   return;
+}
+
+/********************************************************************************
+* timer_init_ms: Initierar ny timerkrets med angiven tid mätt i hela
+*                millisekunder. Beräkningen av timerinställningar sker helt
+*                med heltal, vilket undviker flyttalsbiblioteket.
+*
+*                - self     : Pekare till timern som ska initieras.
+*                - timer_sel: Val av timerkrets.
+*                - time_ms  : Tiden timern ska sättas på mätt i millisekunder.
+********************************************************************************/
+void timer_init_ms(struct timer* self,
+                   const enum timer_sel timer_sel,
+                   const uint32_t time_ms)
+{
+   self->counter = 0;
+   self->timer_sel = timer_sel;
+   timer_set_period(self, timer_get_cycles_ms(time_ms));
+   timer_init_circuit(self);
+   return;
+}
+
+/********************************************************************************
+* timer_init_config: Initierar ny timerkrets med färdigberäknade
+*                    timerinställningar, exempelvis från makrot TIMER_CONFIG.
+*
+*                    - self  : Pekare till timern som ska initieras.
+*                    - config: Timerinställningar inklusive timerkrets.
+********************************************************************************/
+void timer_init_config(struct timer* self,
+                       const struct timer_config config)
+{
+   self->counter = 0;
+   self->timer_sel = config.timer_sel;
+   self->max_count = config.max_count;
+   self->compare_value = config.compare_value;
+   self->prescaler_bits = config.prescaler_bits;
+   timer_init_circuit(self);
+   return;
+}
+
+/********************************************************************************
+* timer_clear: Genomför total nollställning av angiven timerkrets.
+*
+*              - self: Pekare till timern som ska nollställas.
+********************************************************************************/
+void timer_clear(struct timer* self)
+{
+   timer_disable_circuit(self);
+   self->counter = 0;
+   self->max_count = 0;
+   self->timsk = 0;
+   self->timsk_bit = 0;
+   self->prescaler_bits = 0;
+   self->compare_value = 0;
+   self->timer_sel = TIMER_SEL_NONE;
+   return;
+}
+
+/********************************************************************************
+* timer_toggle_interrupt: Togglar aktivering av timergenererat avbrott på
+*                         angiven timer. Om avbrott är aktiverat vid anrop sker 
+*                         inaktivering. På samma sätt gäller att om avbrott är 
+*                         inaktiverat vid anrop så sker aktivering.
+*
+*                         - self: Pekare till timern som aktivering av
+*                                 timergenererat avbrott ska togglas på.
+********************************************************************************/
+void timer_toggle_interrupt(struct timer* self)
+{
+   if (timer_interrupt_enabled(self))
+   {
+      timer_disable_interrupt(self);
+   }
+   else
+   {
+      timer_enable_interrupt(self);
+   }
+   return;
+}
+
+/********************************************************************************
+* timer_elapsed: Indikerar ifall angiven timer har löpt ut genom att returnera
+*                true eller false. Ifall timern har löpt ut dras antalet
+*                avbrott per period från räknaren i stället för att den
+*                nollställs, så att avbrott som redan har räknats in på nästa
+*                period behålls och timern inte driver över tid.
+*
+*                - self: Pekare till timern som ska kontrolleras.
+********************************************************************************/
+bool timer_elapsed(struct timer* self)
+{
+   if (self->counter >= self->max_count)
+   {
+      self->counter -= self->max_count;
+      return true;
+   }
+   else
+   {
+      return false;
+   }
+}
+
+/********************************************************************************
+* timer_reset: Återställer angiven timer till startläget.
+*
+               - self: Pekare till timern som ska återställas.
+********************************************************************************/
+void timer_reset(struct timer* self)
+{
+   timer_disable_interrupt(self);
+   self->counter = 0;
+   return;
+}
+
+/********************************************************************************
+* timer_set_new_time: Sätter ny tid på angiven timerkrets mätt i millisekunder.
+* 
+*                     - self   : Pekare till timern vars tid ska uppdateras.
+*                     - time_ms: Tiden timern ska sättas på i millisekunder.
+********************************************************************************/
+void timer_set_new_time(struct timer* self, 
+                        const double time_ms)
+{
+   timer_set_period(self, timer_get_cycles(time_ms));
+   timer_write_compare(self);
+   return;
+}
+
+/********************************************************************************
+* timer_set_new_time_ms: Sätter ny tid mätt i hela millisekunder på angiven
+*                        timerkrets, beräknat med heltal.
+*
+*                        - self   : Pekare till timern vars tid ska uppdateras.
+*                        - time_ms: Tiden timern ska sättas på mätt i millisekunder.
+********************************************************************************/
+void timer_set_new_time_ms(struct timer* self,
+                           const uint32_t time_ms)
+{
+   timer_set_period(self, timer_get_cycles_ms(time_ms));
+   timer_write_compare(self);
+   return;
+}
+
+/********************************************************************************
+* timer_restart_period: Nollställer timerkretsens räknarregister samt eventuell
+*                       väntande avbrottsflagga, så att nästa compare-period
+*                       påbörjas från noll.
+*
+*                       - self: Pekare till timern vars period ska startas om.
+********************************************************************************/
+void timer_restart_period(struct timer* self)
+{
+   if (self->timer_sel == TIMER_SEL_0)
+   {
+      TCNT0 = 0x00;
+      TIFR0 = (1 << OCF0A);
+   }
+   else if (self->timer_sel == TIMER_SEL_2)
+   {
+      TCNT2 = 0x00;
+      TIFR2 = (1 << OCF2A);
+   }
+   return;
+}
+
+/********************************************************************************
+* timer_init_circuit: Initierar angiven timerkrets i CTC Mode med tidigare
+*                     beräknad prescaler samt compare-värde. Vid aktiverat
+*                     avbrott sker timergenererat avbrott varje gång räknaren
+*                     når compare-värdet. Adresserna till motsvarande
+*                     maskregister som bit för aktivering av avbrott sparas.
+*
+*                     - self     : Pekare till timerkretsen som ska initieras.
+********************************************************************************/
+static void timer_init_circuit(struct timer* self)
+{
+   if (self->timer_sel == TIMER_SEL_0)
+   {
+      TCCR0A = (1 << WGM01);
+      self->timsk = &TIMSK0;
+      self->timsk_bit = OCIE0A;
+   }
+   else if (self->timer_sel == TIMER_SEL_2)
+   {
+      TCCR2A = (1 << WGM21);
+      self->timsk = &TIMSK2;
+      self->timsk_bit = OCIE2A;
+   }
+
+   timer_write_compare(self);
+   asm("SEI");
+   return;
+}
+
+/********************************************************************************
+* timer_disable_circuit: Inaktiverar angiven timerkrets så att varken uppräkning
+*                        eller avbrott kan ske. 
+*
+*                        - self: Pekare till timern som ska inaktiveras.  
+********************************************************************************/
+static void timer_disable_circuit(struct timer* self)
+{
+   if (self->timer_sel == TIMER_SEL_0)
+   {
+      TCCR0A = 0x00;
+      TCCR0B = 0x00;
+      TIMSK0 = 0x00;
+      OCR0A = 0x00;
+   }
+   else if (self->timer_sel == TIMER_SEL_2)
+   {
+      TCCR2A = 0x00;
+      TCCR2B = 0x00;
+      TIMSK2 = 0x00;
+      OCR2A = 0x00;
+   }
+   return;
+}
+
+/********************************************************************************
+* timer_write_compare: Skriver timerns prescaler samt compare-värde till
+*                      motsvarande timerkrets. Timerkretsen sätts samtidigt
+*                      i CTC Mode, så att räknaren nollställs vid compare.
+*
+*                      - self: Pekare till timern vars inställningar ska
+*                              skrivas till timerkretsen.
+********************************************************************************/
+static void timer_write_compare(const struct timer* self)
+{
+   if (self->timer_sel == TIMER_SEL_0)
+   {
+      OCR0A = (uint8_t)self->compare_value;
+      TCCR0B = self->prescaler_bits;
+   }
+   else if (self->timer_sel == TIMER_SEL_2)
+   {
+      OCR2A = (uint8_t)self->compare_value;
+      TCCR2B = self->prescaler_bits;
+   }
+   return;
+}
+
+/********************************************************************************
+* timer_set_period: Väljer prescaler, compare-värde samt antalet compare-avbrott
+*                   för angivet antal klockcykler. Minsta prescaler som ryms
+*                   inom en period väljs för bästa upplösning. Tider som är
+*                   längre än en period med högsta prescaler delas upp i
+*                   flera lika långa compare-perioder.
+*
+*                   - self  : Pekare till timern vars period ska sättas.
+*                   - cycles: Önskad tid mätt i klockcykler.
+********************************************************************************/
+static void timer_set_period(struct timer* self,
+                             const uint32_t cycles)
+{
+   const struct timer_prescaler* prescalers = timer0_prescalers;
+   uint8_t num_prescalers = sizeof(timer0_prescalers) / sizeof(struct timer_prescaler);
+   const uint32_t top = TIMER_8BIT_TOP;
+   uint32_t counts = 0;
+
+   if (self->timer_sel == TIMER_SEL_2)
+   {
+      prescalers = timer2_prescalers;
+      num_prescalers = sizeof(timer2_prescalers) / sizeof(struct timer_prescaler);
+   }
+
+   for (uint8_t i = 0; i < num_prescalers; ++i)
+   {
+      const uint16_t division = prescalers[i].division;
+      counts = (cycles + division / 2) / division;
+      self->prescaler_bits = prescalers[i].bits;
+      if (counts <= top) break;
+   }
+
+   if (counts == 0) counts = 1;
+   self->max_count = (counts + top - 1) / top;
+   self->compare_value = (uint16_t)((counts + self->max_count / 2) / self->max_count - 1);
+   return;
+}
+
+/********************************************************************************
+* timer_get_cycles: Returnerar antalet klockcykler som motsvarar angiven tid,
+*                   avrundat till närmaste heltal. Tider längre än
+*                   TIMER_TIME_MAX_MS begränsas till denna tid, likt
+*                   timer_get_cycles_ms, medan negativa tider ger noll, så
+*                   att omvandlingen till heltal alltid är definierad.
+*
+*                   - time_ms: Önskad tid mätt i millisekunder.
+********************************************************************************/
+static inline uint32_t timer_get_cycles(const double time_ms)
+{
+   if (!(time_ms > 0)) return 0;
+   if (time_ms >= TIMER_TIME_MAX_MS) return TIMER_TIME_MAX_MS * TIMER_CYCLES_PER_MS;
+   return (uint32_t)(time_ms * (F_CPU / 1000.0) + 0.5);
+}
+
+/********************************************************************************
+* timer_get_cycles_ms: Returnerar antalet klockcykler som motsvarar angiven tid
+*                      mätt i hela millisekunder. Tider längre än
+*                      TIMER_TIME_MAX_MS begränsas till denna tid.
+*
+*                      - time_ms: Önskad tid mätt i millisekunder.
+********************************************************************************/
+static inline uint32_t timer_get_cycles_ms(const uint32_t time_ms)
+{
+   if (time_ms > TIMER_TIME_MAX_MS) return TIMER_TIME_MAX_MS * TIMER_CYCLES_PER_MS;
+   return time_ms * TIMER_CYCLES_PER_MS;
 }
\ No newline at end of file
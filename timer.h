@@ -1,176 +1,327 @@
-/********************************************************************************
-* timer.h: Innehller drivrutiner fr interruptbaserade timerkretsar via 
-*          strukten timer samt associerade funktioner. Dessa timerkretsar 
-*          fungerar ocks utmrkt att anvnda som rknare.
-********************************************************************************/
-#ifndef TIMER_H_
-#define TIMER_H_
-
-/* Inkluderingsdirektiv: */
-#include "misc.h"
-
-/********************************************************************************
-* timer_sel: Enumeration fr val av timerkrets.
-********************************************************************************/
-enum timer_sel
-{
-   TIMER_SEL_0,   /* Timer 0. */
-   TIMER_SEL_1,   /* Timer 1. */
-   TIMER_SEL_2,   /* Timer 2. */
-   TIMER_SEL_NONE /* Timer ospecificerad. */
-};
-
-/********************************************************************************
-* timer: Strukt fr implementering av interruptbaserade timerkretsar, som
-*        vid behov kan anvndas som rknare.
-********************************************************************************/
-struct timer
-{
-   volatile uint32_t counter; /* 32-bitars rknare. */
-   uint32_t max_count;        /* Maxvrde som upprkning ska ske till. */
-   volatile uint8_t* timsk;   /* Pekare till maskregister fr aktivering av avbrott. */
-   uint8_t timsk_bit;         /* Bit fr aktivering av avbrott i motsvarande maskregister. */
-   enum timer_sel timer_sel;  /* Val av timerkrets. */
-};
-
-/********************************************************************************
-* timer_init: Initierar ny timerkrets med angiven tid mtt i millisekunder.
-*             Om timern ska anvndas som rknare fr att rkna upp till ett
-*             specifikt maxvrde br funktionen timer_set_max_count anropas
-*             direkt efter initieringen.
-*
-*             - self     : Pekare till timern som ska initieras.
-*             - timer_sel: Val av timerkrets.
-*             - time_ms  : Tiden timern ska sttas p mtt i millisekunder.
-********************************************************************************/
-void timer_init(struct timer* self, 
-                const enum timer_sel timer_sel, 
-                const double time_ms);
-
-/********************************************************************************
-* timer_clear: Genomfr total nollstllning av angiven timerkrets.
-*
-*              - self: Pekare till timern som ska nollstllas.
-********************************************************************************/
-void timer_clear(struct timer* self);
-
-/********************************************************************************
-* timer_enable_interrupt: Aktiverar timergenererat avbrott, som ger rum nr
-*                         timern rknar upp till overflow eller specificerat max.
-*
-*                         Timer 0 samt Timer 2 aktiveras i Normal Mode, medan
-*                         Timer 1 aktiveras i CTC Mode med upprkning till 256,
-*                         vilket gr att tiden mellan varje timergenererat
-*                         avbrott r samma oavsett anvnd timerkrets.
-*
-*                         Avbrottsvektorer fr timerkretsarna deklareras nedan:
-*
-*                         Timerkrets     Avbrottsvektor
-*                           Timer 0     TIMER0_OVF_vect
-*                           Timer 1     TIMER1_COMPA_vect
-*                           Timer 2     TIMER2_OVF_vect
-*
-*                         - self: Pekare till timern som timergenererat
-*                                 avbrott ska aktiveras p.
-********************************************************************************/
-static inline void timer_enable_interrupt(struct timer* self)
-{
-   *(self->timsk) |= (1 << self->timsk_bit);
-   return;
-}
-
-/********************************************************************************
-* timer_disable_interrupt: Inaktiverar timergenererat avbrott p angiven timer.
-*
-*                          - self: Pekare till timern som timergenererat
-*                                  avbrott ska inaktiveras p.
-********************************************************************************/
-static inline void timer_disable_interrupt(struct timer* self)
-{
-   *(self->timsk) &= ~(1 << self->timsk_bit);
-   return;
-}
-
-/********************************************************************************
-* timer_toggle_interrupt: Togglar aktivering av timergenererat avbrott p
-*                         angiven timer.
-*
-*                         - self: Pekare till timern som aktivering av 
-*                                 timergenererat avbrott ska togglas p.
-********************************************************************************/
-void timer_toggle_interrupt(struct timer* self);
-
-/********************************************************************************
-* timer_interrupt_enabled: Indikerar ifall timergenererat avbrott r aktiverat
-*                          p angiven timer.
-*
-*                          - self: Pekare till timern vars avbrottstillstnd
-*                                  ska kontrolleras.
-********************************************************************************/
-static inline bool timer_interrupt_enabled(const struct timer* self)
-{
-   return (*(self->timsk) & (1 << self->timsk_bit));
-}
-
-/********************************************************************************
-* timer_count: Rknar upp angiven timer.
-*
-*              - self: Pekare till timern som ska rknas upp.
-********************************************************************************/
-static inline void timer_count(struct timer* self)
-{
-   self->counter++;
-   return;
-}
-
-/********************************************************************************
-* timer_elapsed: Indikerar ifall angiven timer har lpt ut genom att returnera
-*                true eller false. Ifall timern har lpt ut nollstlls rknaren
-*                infr nsta upprkning.
-*
-*                - self: Pekare till timern som ska kontrolleras.
-********************************************************************************/
-bool timer_elapsed(struct timer* self);
-
-/********************************************************************************
-* timer_reset_counter: Nollstller rknaren p angiven timer.
-*
-*                      - self: Pekare till timern vars rknare ska nollstllas.
-********************************************************************************/
-static inline void timer_reset_counter(struct timer* self)
-{
-   self->counter = 0;
-   return;
-}
-
-/********************************************************************************
-* timer_reset: terstller angiven timer till startlget.
-*
-               - self: Pekare till timern som ska terstllas.
-********************************************************************************/
-void timer_reset(struct timer* self);
-
-/********************************************************************************
-* timer_set_new_time: Stter ny tid p angiven timerkrets.
-*
-*                    - self   : Pekare till timern vars tid ska uppdateras.
-*                    - time_ms: Tiden timern ska sttas p mtt i millisekunder.
-********************************************************************************/
-void timer_set_new_time(struct timer* self, 
-                        const double time_ms);
-
-/********************************************************************************
-* timer_set_new_max_count: Stter nytt maxvrde fr upprkning av timern nr
-*                          denna ska anvndas som en rknare.
-*
-*                          - self   : Pekare till timern.
-*                          - max_count: Maxvrde fr upprkningen.
-********************************************************************************/
-static inline void timer_set_max_count(struct timer* self,
-                                       const uint32_t max_count)
-{
-   self->max_count = max_count;
-   return;
-}
-
+/********************************************************************************
+* timer.h: Innehåller drivrutiner för interruptbaserade timerkretsar via 
+*          strukten timer samt associerade funktioner. Dessa timerkretsar 
+*          fungerar också utmärkt att använda som räknare.
+********************************************************************************/
+#ifndef TIMER_H_
+#define TIMER_H_
+
+/* Inkluderingsdirektiv: */
+#include "misc.h"
+
+/********************************************************************************
+* timer_sel: Enumeration för val av timerkrets. Timer 1 kan inte väljas,
+*            eftersom den används som fritt löpande tidsbas av systemklockan
+*            (se sysclock.h), som även delas av mjukvarutimers, icp.h samt
+*            triggning av AD-omvandling via OCR1B.
+********************************************************************************/
+enum timer_sel
+{
+   TIMER_SEL_0,   /* Timer 0. */
+   TIMER_SEL_2,   /* Timer 2. */
+   TIMER_SEL_NONE /* Timer ospecificerad. */
+};
+
+/* Makrodefinitioner: */
+#define TIMER_CYCLES_PER_MS (F_CPU / 1000UL)                 /* Klockcykler per millisekund. */
+#define TIMER_TIME_MAX_MS (0xFFFFFFFFUL / TIMER_CYCLES_PER_MS) /* Längsta tid som kan anges. */
+#define TIMER_8BIT_TOP 256UL                                 /* Räknarsteg per period, Timer 0 samt 2. */
+
+/********************************************************************************
+* timer_config: Strukt för lagring av vald timerkrets, prescaler,
+*               compare-värde samt antalet compare-avbrott per period.
+*               Inställningarna kan beräknas vid kompilering via makrot
+*               TIMER_CONFIG. Eftersom timerkretsen lagras tillsammans med
+*               inställningarna kan dessa inte av misstag användas för en
+*               annan timerkrets än den de beräknades för.
+********************************************************************************/
+struct timer_config
+{
+   uint32_t max_count;       /* Antal compare-avbrott per period. */
+   uint16_t compare_value;   /* Värde som skrivs till OCRnA. */
+   uint8_t prescaler_bits;   /* Bitar CSn2 - CSn0 för vald prescaler. */
+   enum timer_sel timer_sel; /* Timerkretsen som inställningarna gäller för. */
+};
+
+/********************************************************************************
+* Makron för beräkning av timerinställningar vid kompilering. Beräkningen
+* följer samma algoritm som vid körning: minsta prescaler vars period rymmer
+* angiven tid väljs, annars används prescaler 1024 och tiden delas upp i
+* flera lika långa compare-perioder. Samtliga makron förutsätter att angiven
+* tid är en konstant, varvid uttrycken beräknas helt av kompilatorn utan
+* flyttal eller division vid körning.
+********************************************************************************/
+#define TIMER_TOP(timer_sel) TIMER_8BIT_TOP
+
+#define TIMER_CYCLES(time_ms) ((uint32_t)(time_ms) * TIMER_CYCLES_PER_MS)
+
+#define TIMER_COUNTS(cycles, division) (((cycles) + (division) / 2) / (division))
+
+#define TIMER_FITS(timer_sel, cycles, division) \
+   (TIMER_COUNTS(cycles, division) <= TIMER_TOP(timer_sel))
+
+#define TIMER_DIVISION(timer_sel, cycles) \
+   ((timer_sel) == TIMER_SEL_2 ? \
+   (TIMER_FITS(timer_sel, cycles, 1UL) ? 1UL : \
+    TIMER_FITS(timer_sel, cycles, 8UL) ? 8UL : \
+    TIMER_FITS(timer_sel, cycles, 32UL) ? 32UL : \
+    TIMER_FITS(timer_sel, cycles, 64UL) ? 64UL : \
+    TIMER_FITS(timer_sel, cycles, 128UL) ? 128UL : \
+    TIMER_FITS(timer_sel, cycles, 256UL) ? 256UL : 1024UL) : \
+   (TIMER_FITS(timer_sel, cycles, 1UL) ? 1UL : \
+    TIMER_FITS(timer_sel, cycles, 8UL) ? 8UL : \
+    TIMER_FITS(timer_sel, cycles, 64UL) ? 64UL : \
+    TIMER_FITS(timer_sel, cycles, 256UL) ? 256UL : 1024UL))
+
+#define TIMER_PRESCALER_BITS(timer_sel, division) \
+   ((timer_sel) == TIMER_SEL_2 ? \
+   ((division) == 1UL ? 1 : (division) == 8UL ? 2 : (division) == 32UL ? 3 : \
+    (division) == 64UL ? 4 : (division) == 128UL ? 5 : (division) == 256UL ? 6 : 7) : \
+   ((division) == 1UL ? 1 : (division) == 8UL ? 2 : (division) == 64UL ? 3 : \
+    (division) == 256UL ? 4 : 5))
+
+#define TIMER_TOTAL_COUNTS(timer_sel, cycles) \
+   (TIMER_COUNTS(cycles, TIMER_DIVISION(timer_sel, cycles)) ? \
+    TIMER_COUNTS(cycles, TIMER_DIVISION(timer_sel, cycles)) : 1UL)
+
+#define TIMER_MAX_COUNT(timer_sel, cycles) \
+   ((TIMER_TOTAL_COUNTS(timer_sel, cycles) + TIMER_TOP(timer_sel) - 1) / TIMER_TOP(timer_sel))
+
+#define TIMER_COMPARE_VALUE(timer_sel, cycles) \
+   ((TIMER_TOTAL_COUNTS(timer_sel, cycles) + TIMER_MAX_COUNT(timer_sel, cycles) / 2) / \
+     TIMER_MAX_COUNT(timer_sel, cycles) - 1)
+
+/* Ger kompileringsfel (negativ arraystorlek) om angiven tid ligger utanför giltigt intervall. */
+#define TIMER_RANGE_CHECK(time_ms) \
+   (0 * sizeof(char[((time_ms) > 0 && (time_ms) <= TIMER_TIME_MAX_MS) ? 1 : -1]))
+
+/********************************************************************************
+* TIMER_CONFIG: Beräknar timerinställningar för angiven timerkrets samt
+*               konstant tid mätt i hela millisekunder vid kompilering.
+*               Tider utanför intervallet 1 - TIMER_TIME_MAX_MS ger
+*               kompileringsfel. Används tillsammans med timer_init_config,
+*               som hämtar timerkretsen från inställningarna.
+*
+*               - sel    : Val av timerkrets.
+*               - time_ms: Tiden timern ska sättas på mätt i millisekunder.
+********************************************************************************/
+#define TIMER_CONFIG(sel, time_ms) \
+   ((struct timer_config) \
+   { \
+      .max_count = TIMER_MAX_COUNT(sel, TIMER_CYCLES(time_ms)) + TIMER_RANGE_CHECK(time_ms), \
+      .compare_value = TIMER_COMPARE_VALUE(sel, TIMER_CYCLES(time_ms)), \
+      .prescaler_bits = TIMER_PRESCALER_BITS(sel, TIMER_DIVISION(sel, TIMER_CYCLES(time_ms))), \
+      .timer_sel = (sel) \
+   })
+
+/********************************************************************************
+* timer: Strukt för implementering av interruptbaserade timerkretsar, som
+*        vid behov kan användas som räknare.
+********************************************************************************/
+struct timer
+{
+   volatile uint32_t counter; /* 32-bitars räknare. */
+   uint32_t max_count;        /* Maxvärde som uppräkning ska ske till. */
+   volatile uint8_t* timsk;   /* Pekare till maskregister för aktivering av avbrott. */
+   uint8_t timsk_bit;         /* Bit för aktivering av avbrott i motsvarande maskregister. */
+   uint8_t prescaler_bits;    /* Bitar CSn2 - CSn0 för vald prescaler. */
+   uint16_t compare_value;    /* Värde som skrivs till OCRnA (räknarens topp i CTC Mode). */
+   enum timer_sel timer_sel;  /* Val av timerkrets. */
+};
+
+/********************************************************************************
+* timer_init: Initierar ny timerkrets med angiven tid mätt i millisekunder.
+*             Om timern ska användas som räknare för att räkna upp till ett
+*             specifikt maxvärde bör funktionen timer_set_max_count anropas
+*             direkt efter initieringen. Prescaler samt compare-värde väljs
+*             utefter angiven tid, så att varje period kostar så få
+*             timergenererade avbrott som möjligt.
+*
+*             - self     : Pekare till timern som ska initieras.
+*             - timer_sel: Val av timerkrets.
+*             - time_ms  : Tiden timern ska sättas på mätt i millisekunder.
+********************************************************************************/
+void timer_init(struct timer* self, 
+                const enum timer_sel timer_sel, 
+                const double time_ms);
+
+/********************************************************************************
+* timer_init_ms: Initierar ny timerkrets med angiven tid mätt i hela
+*                millisekunder. Beräkningen av timerinställningar sker helt
+*                med heltal, vilket undviker flyttalsbiblioteket.
+*
+*                - self     : Pekare till timern som ska initieras.
+*                - timer_sel: Val av timerkrets.
+*                - time_ms  : Tiden timern ska sättas på mätt i millisekunder.
+********************************************************************************/
+void timer_init_ms(struct timer* self,
+                   const enum timer_sel timer_sel,
+                   const uint32_t time_ms);
+
+/********************************************************************************
+* timer_init_config: Initierar ny timerkrets med färdigberäknade
+*                    timerinställningar, exempelvis från makrot TIMER_CONFIG.
+*                    Timerkretsen anges endast en gång, i inställningarna.
+*                    Ingen beräkning sker vid körning:
+*
+*                    timer_init_config(&t0, TIMER_CONFIG(TIMER_SEL_0, 300));
+*
+*                    - self  : Pekare till timern som ska initieras.
+*                    - config: Timerinställningar inklusive timerkrets.
+********************************************************************************/
+void timer_init_config(struct timer* self,
+                       const struct timer_config config);
+
+/********************************************************************************
+* timer_clear: Genomför total nollställning av angiven timerkrets.
+*
+*              - self: Pekare till timern som ska nollställas.
+********************************************************************************/
+void timer_clear(struct timer* self);
+
+/********************************************************************************
+* timer_restart_period: Nollställer timerkretsens räknarregister samt eventuell
+*                       väntande avbrottsflagga, så att nästa compare-period
+*                       påbörjas från noll.
+*
+*                       - self: Pekare till timern vars period ska startas om.
+********************************************************************************/
+void timer_restart_period(struct timer* self);
+
+/********************************************************************************
+* timer_enable_interrupt: Aktiverar timergenererat avbrott, som äger rum när
+*                         timerkretsen räknar upp till sitt compare-värde.
+*
+*                         Samtliga timerkretsar körs i CTC Mode, där prescaler
+*                         samt compare-värde (OCRnA) väljs per timer utefter
+*                         angiven tid. En period kostar därmed ett eller ett
+*                         fåtal avbrott i stället för ett avbrott var 0.128:e
+*                         millisekund. Perioden startas om från noll vid
+*                         aktivering.
+*
+*                         Avbrottsvektorer för timerkretsarna deklareras nedan:
+*
+*                         Timerkrets     Avbrottsvektor
+*                           Timer 0     TIMER0_COMPA_vect
+*                           Timer 2     TIMER2_COMPA_vect
+*
+*                         TIMER1_COMPA_vect definieras av systemklockan
+*                         (sysclock.c) och får inte definieras av programmet.
+*
+*                         - self: Pekare till timern som timergenererat
+*                                 avbrott ska aktiveras på.
+********************************************************************************/
+static inline void timer_enable_interrupt(struct timer* self)
+{
+   timer_restart_period(self);
+   *(self->timsk) |= (1 << self->timsk_bit);
+   return;
+}
+
+/********************************************************************************
+* timer_disable_interrupt: Inaktiverar timergenererat avbrott på angiven timer.
+*
+*                          - self: Pekare till timern som timergenererat
+*                                  avbrott ska inaktiveras på.
+********************************************************************************/
+static inline void timer_disable_interrupt(struct timer* self)
+{
+   *(self->timsk) &= ~(1 << self->timsk_bit);
+   return;
+}
+
+/********************************************************************************
+* timer_toggle_interrupt: Togglar aktivering av timergenererat avbrott på
+*                         angiven timer.
+*
+*                         - self: Pekare till timern som aktivering av 
+*                                 timergenererat avbrott ska togglas på.
+********************************************************************************/
+void timer_toggle_interrupt(struct timer* self);
+
+/********************************************************************************
+* timer_interrupt_enabled: Indikerar ifall timergenererat avbrott är aktiverat
+*                          på angiven timer.
+*
+*                          - self: Pekare till timern vars avbrottstillstånd
+*                                  ska kontrolleras.
+********************************************************************************/
+static inline bool timer_interrupt_enabled(const struct timer* self)
+{
+   return (*(self->timsk) & (1 << self->timsk_bit));
+}
+
+/********************************************************************************
+* timer_count: Räknar upp angiven timer.
+*
+*              - self: Pekare till timern som ska räknas upp.
+********************************************************************************/
+static inline void timer_count(struct timer* self)
+{
+   self->counter++;
+   return;
+}
+
+/********************************************************************************
+* timer_elapsed: Indikerar ifall angiven timer har löpt ut genom att returnera
+*                true eller false. Ifall timern har löpt ut dras antalet
+*                avbrott per period från räknaren i stället för att den
+*                nollställs, så att avbrott som redan har räknats in på nästa
+*                period behålls och timern inte driver över tid.
+*
+*                - self: Pekare till timern som ska kontrolleras.
+********************************************************************************/
+bool timer_elapsed(struct timer* self);
+
+/********************************************************************************
+* timer_reset_counter: Nollställer räknaren på angiven timer.
+*
+*                      - self: Pekare till timern vars räknare ska nollställas.
+********************************************************************************/
+static inline void timer_reset_counter(struct timer* self)
+{
+   self->counter = 0;
+   return;
+}
+
+/********************************************************************************
+* timer_reset: Återställer angiven timer till startläget.
+*
+               - self: Pekare till timern som ska återställas.
+********************************************************************************/
+void timer_reset(struct timer* self);
+
+/********************************************************************************
+* timer_set_new_time: Sätter ny tid på angiven timerkrets.
+*
+*                    - self   : Pekare till timern vars tid ska uppdateras.
+*                    - time_ms: Tiden timern ska sättas på mätt i millisekunder.
+********************************************************************************/
+void timer_set_new_time(struct timer* self, 
+                        const double time_ms);
+
+/********************************************************************************
+* timer_set_new_time_ms: Sätter ny tid mätt i hela millisekunder på angiven
+*                        timerkrets, beräknat med heltal.
+*
+*                        - self   : Pekare till timern vars tid ska uppdateras.
+*                        - time_ms: Tiden timern ska sättas på mätt i millisekunder.
+********************************************************************************/
+void timer_set_new_time_ms(struct timer* self,
+                           const uint32_t time_ms);
+
+/********************************************************************************
+* timer_set_new_max_count: Sätter nytt maxvärde för uppräkning av timern när
+*                          denna ska användas som en räknare.
+*
+*                          - self   : Pekare till timern.
+*                          - max_count: Maxvärde för uppräkningen.
+********************************************************************************/
+static inline void timer_set_max_count(struct timer* self,
+                                       const uint32_t max_count)
+{
+   self->max_count = max_count;
+   return;
+}
+
 #endif /* TIMER_H_ */
\ No newline at end of file
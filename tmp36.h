@@ -1,92 +1,119 @@
-/********************************************************************************
-* tmp36.h: Innehller drivrutiner fr temperatursensor TMP36, som anvnds fr
-*          mtning samt utskrift av rumstemperaturen. Den analoga insignalen
-*          frn TMP36 AD-omvandlas till en digital motsvarighet, som anvnds
-*          fr att berkna aktuell temperatur. Utskrift sker till en seriell
-*          terminal via USART.
-********************************************************************************/
-#ifndef TMP36_H_
-#define TMP36_H_
-
-/* Inkluderingsdirektiv: */
-#include "adc.h"
-#include "serial.h"
-
-/* Makrodefinitioner: */
-#define VCC 5.0 /* 5 V matningsspnning. */
-
-/********************************************************************************
-* tmp36: Strukt fr implementering av temperatursensor TMP36, som anvnds fr
-*        mtning samt utskrift av rumstemperaturen. Vid avlsning AD-omvandlas
-*        den analoga insignalen till en digital motsvarighet. Utefter detta
-*        vrde berknas den analoga inspnningen Uin via nedanstende formel:
-*
-*        Uin = ADC_result / ADC_MAX * Vcc,
-*
-*        dr ADC_result r den AD-omvandlade insignalen (0 - 1023),
-*        ADC_MAX r hgsta mjliga digitala signal (1023) och Vcc r 
-*        mikrodatorns matningsspnning (5 V).
-*
-*        Temperaturen T berknas utefter detta vrde via nedanstende formel:
-*
-*        T = 100 * Uin - 50,
-*
-*        dr Uin utgr analog inspnning avlst frn temperatursensor TMP36.
-********************************************************************************/
-struct tmp36
-{
-   struct adc adc; /* AD-omvandlare, omvandlar analog insignal frn TMP36. */
-};
-
-/********************************************************************************
-* tmp36_init: Initierar pin ansluten till temperatursensor TMP36 fr mtning
-*             samt utskrift av rumstemperaturen. Seriell verfring initieras
-*             ocks med en baud rate (verfringshastighet) p 9600 kbps.
-*
-*             - self: Pekare till temperatursensorn som ska initieras.
-*             - pin : Analog pin A0 - A5 som temperatursensorn r ansluten till.
-********************************************************************************/
-void tmp36_init(struct tmp36* self, 
-                const uint8_t pin);
-
-/********************************************************************************
-* adc_get_input_voltage: Returnerar inspnningen frn angiven tempsensor genom
-*                        att lsa av insignalen, omvandla till motsvarande
-*                        digitala vrde och sedan berkna motsvarande inspnning.
-*                        Vrdet berknas efter en matningsspnning p 5 V.
-*
-*                        - self: Pekare till temperatursensor TMP36.
-********************************************************************************/
-static inline double tmp36_get_input_voltage(const struct tmp36* self)
-{
-   return adc_duty_cycle(&self->adc) * VCC;
-}
-
-/********************************************************************************
-* tmp36_get_temperature: Returnerar aktuell rumstemperatur via avlsning av
-*                        angiven temperatursensor TMP36.
-*
-*                        - self: Pekare till temperatursensor TMP36.
-********************************************************************************/
-static inline double tmp36_get_temperature(const struct tmp36* self)
-{
-   return 100 * tmp36_get_input_voltage(self) - 50;
-}
-
-/********************************************************************************
-* tmp36_print_temperature: Skriver ut aktuell rumstemperatur avlst av
-*                          temperatursensor TMP36.
-*
-*                          - self: Pekare till temperatursensor TMP36.
-********************************************************************************/
-void tmp36_print_temperature(const struct tmp36* self);
-
-/********************************************************************************
-* tmp36_print_voltage: Skriver ut aktuell inspnning avlst av temperatursensor
-*                      TMP36 mtt i V.
-*
-*                      - self: Pekare till temperatursensor TMP36.
-********************************************************************************/
-void tmp36_print_voltage(const struct tmp36* self);
-
+/********************************************************************************
+* tmp36.h: Innehåller drivrutiner för temperatursensor TMP36, som används för
+*          mätning samt utskrift av rumstemperaturen. Den analoga insignalen
+*          från TMP36 AD-omvandlas till en digital motsvarighet, som används
+*          för att beräkna aktuell temperatur. Utskrift sker till en seriell
+*          terminal via USART.
+********************************************************************************/
+#ifndef TMP36_H_
+#define TMP36_H_
+
+/* Inkluderingsdirektiv: */
+#include "adc.h"
+#include "serial.h"
+
+/* Makrodefinitioner: */
+#define VCC 5.0 /* 5 V matningsspänning. */
+
+/********************************************************************************
+* tmp36: Strukt för implementering av temperatursensor TMP36, som används för
+*        mätning samt utskrift av rumstemperaturen. Vid avläsning AD-omvandlas
+*        den analoga insignalen till en digital motsvarighet, som skalas
+*        till duty cycle i Q0.16-format via adc_duty_cycle_q16. Utefter
+*        detta värde beräknas den analoga inspänningen Uin via nedanstående
+*        formel:
+*
+*        Uin = duty_q16 / 65535 * Vcc,
+*
+*        där duty_q16 = ADC_result * 65535 / (2^adc_resolution() - 1),
+*        beräknat via bitreplikering (se adc_scale_q16). ADC_result är den
+*        AD-omvandlade insignalen (0 - 1023 vid 10 bitar), adc_resolution()
+*        är aktuell upplösning i bitar (se adc_set_oversampling) och Vcc är
+*        mikrodatorns matningsspänning (5 V).
+*
+*        Temperaturen T beräknas utefter detta värde via nedanstående formel:
+*
+*        T = 100 * Uin - 50,
+*
+*        där Uin utgör analog inspänning avläst från temperatursensor TMP36.
+********************************************************************************/
+struct tmp36
+{
+   struct adc adc; /* AD-omvandlare, omvandlar analog insignal från TMP36. */
+};
+
+/********************************************************************************
+* tmp36_init: Initierar pin ansluten till temperatursensor TMP36 för mätning
+*             samt utskrift av rumstemperaturen. Seriell överföring initieras
+*             också med en baud rate (överföringshastighet) på 9600 baud.
+*
+*             - self: Pekare till temperatursensorn som ska initieras.
+*             - pin : Analog pin A0 - A5 som temperatursensorn är ansluten till.
+********************************************************************************/
+void tmp36_init(struct tmp36* self, 
+                const uint8_t pin);
+
+/********************************************************************************
+* adc_get_input_voltage: Returnerar inspänningen från angiven tempsensor genom
+*                        att läsa av insignalen, omvandla till motsvarande
+*                        digitala värde och sedan beräkna motsvarande inspänning.
+*                        Värdet beräknas efter en matningsspänning på 5 V.
+*
+*                        - self: Pekare till temperatursensor TMP36.
+********************************************************************************/
+static inline double tmp36_get_input_voltage(const struct tmp36* self)
+{
+   return adc_duty_cycle(&self->adc) * VCC;
+}
+
+/********************************************************************************
+* tmp36_get_millivolts: Returnerar inspänningen från angiven temperatursensor
+*                       i millivolt, beräknat utan flyttal.
+*
+*                       - self: Pekare till temperatursensor TMP36.
+********************************************************************************/
+static inline uint16_t tmp36_get_millivolts(const struct tmp36* self)
+{
+   return adc_get_input_millivolts(&self->adc);
+}
+
+/********************************************************************************
+* tmp36_get_temperature_centi: Returnerar aktuell rumstemperatur i hundradels
+*                              grader, exempelvis 2345 för 23.45 grader,
+*                              beräknat utan flyttal.
+*
+*                              - self: Pekare till temperatursensor TMP36.
+********************************************************************************/
+static inline int16_t tmp36_get_temperature_centi(const struct tmp36* self)
+{
+   return adc_get_temperature_centi(&self->adc);
+}
+
+/********************************************************************************
+* tmp36_get_temperature: Returnerar aktuell rumstemperatur via avläsning av
+*                        angiven temperatursensor TMP36.
+*
+*                        - self: Pekare till temperatursensor TMP36.
+********************************************************************************/
+static inline double tmp36_get_temperature(const struct tmp36* self)
+{
+   return tmp36_get_temperature_centi(self) / 100.0;
+}
+
+/********************************************************************************
+* tmp36_print_temperature: Skriver ut aktuell rumstemperatur avläst av
+*                          temperatursensor TMP36.
+*
+*                          - self: Pekare till temperatursensor TMP36.
+********************************************************************************/
+void tmp36_print_temperature(const struct tmp36* self);
+
+/********************************************************************************
+* tmp36_print_voltage: Skriver ut aktuell inspänning avläst av temperatursensor
+*                      TMP36 mätt i V.
+*
+*                      - self: Pekare till temperatursensor TMP36.
+********************************************************************************/
+void tmp36_print_voltage(const struct tmp36* self);
+
 #endif /* TMP36_H_ */
\ No newline at end of file